@@ -0,0 +1,40 @@
+deps_config := \
+	Config.in.optee \
+	Config.in.secure \
+	device/Config.in.mach \
+	Config.in.app-image \
+	Config.in.u-boot \
+	Config.in.kernel \
+	driver/Config.in.nandflash \
+	driver/Config.in.dataflash \
+	driver/Config.in.nvm \
+	driver/Config.in.dram \
+	driver/Config.in.memory \
+	driver/Config.in.driver \
+	device/Config.in \
+	device/sama7g5/Config.in.con \
+	device/sam9x7/Config.in.con \
+	device/sam9x60/Config.in.con \
+	device/sama5d4/Config.in.con \
+	device/sama5d2/Config.in.con \
+	device/Config.in.clk \
+	device/sama7g5/Config.in \
+	device/sama5d4/Config.in \
+	device/sama5d3/Config.in \
+	device/sama5d2/Config.in \
+	device/sam9x7/Config.in \
+	device/sam9x60/Config.in \
+	device/sama7g5/Config.in.device \
+	device/sama5d4/Config.in.device \
+	device/sama5d3/Config.in.device \
+	device/sama5d2/Config.in.device \
+	device/sam9x7/Config.in.device \
+	device/sam9x60/Config.in.device \
+	device/Config.in.dev \
+	Kconfig
+
+config/at91bootstrap-config/auto.conf: \
+	$(deps_config)
+
+
+$(deps_config): ;
@@ -0,0 +1,128 @@
+/*
+ * Automatically generated C config: don't edit
+ * Sat Oct 17 13:26:29 2026
+ */
+#define CONFIG_CPU_CLK_800MHZ 1
+#define CONFIG_PMC_COMMON 1
+#define CONFIG_LOAD_UBOOT 1
+#define CONFIG_LED_R_ON_PIOB 1
+#define CONFIG_FLEXCOM 1
+#define CONFIG_ALLOW_CPU_CLK_1000MHZ 1
+#define CONFIG_DDR_BENCH_ADDR 0x62000000
+#define CONFIG_PROJECT "sdcard"
+#define CONFIG_TZC400_SIMPLE_PROFILE 1
+#define CONFIG_TOP_OF_MEMORY "0x120000"
+#define CONFIG_WDT2 1
+#define CONFIG_FLEXCOM1_IOSET 4
+#define CONFIG_SDHC 1
+#define CONFIG_HW_DISPLAY_BANNER 1
+#define CONFIG_LOAD_SW 1
+#define CONFIG_SCLK 1
+#define CONFIG_DDR_SET_BY_DEVICE 1
+#define CONFIG_DDR_BENCH_SIZE 0x400000
+#define CONFIG_PUBL 1
+#define CONFIG_CORE_CORTEX_A7 1
+#define CONFIG_SUPPORT_BUS_SPEED_200MHZ 1
+#define CONFIG_CPU_HAS_UMCTL2 1
+#define CONFIG_BACKUP_MODE 1
+#define CONFIG_RSTC 1
+#define CONFIG_BOOTSTRAP_MAXSIZE "65536"
+#define CONFIG_FLEXCOM1 1
+#define CONFIG_WDTS 1
+#define CONFIG_FLEXCOM_TWI_IOSET 1
+#define CONFIG_PMC_PERIPH_CLK_SAM9X5 1
+#define CONFIG_JUMP_TO_SW 1
+#define CONFIG_LED_B_VALUE 0
+#define CONFIG_SDCARD_MAX_IMAGE_SIZE 0x2000000
+#define CONFIG_SDHC1 1
+#define CONFIG_LED_G_VALUE 1
+#define CONFIG_CPU_HAS_AES 1
+#define CONFIG_SDHC_CLOCK_PLANNER 1
+#define CONFIG_CPU_HAS_TRUSTZONE 1
+#define CONFIG_LED_R_VALUE 0
+#define CONFIG_QSPI_IOSET_MAX 1
+#define CONFIG_DEBUG 1
+#define CONFIG_XDMAC 1
+#define CONFIG_MEDIA_SDCARD 1
+#define CONFIG_FATFS 1
+#define CONFIG_PMC_GENERIC_CLK 1
+#define CONFIG_BOARD_QUIRK_SAMA7G5_EK 1
+#define CONFIG_PMIC_ON_TWI 0
+#define CONFIG_SHDWC 1
+#define CONFIG_HAVE_DOT_CONFIG 1
+#define CONFIG_VOLTAGE_LDO1 1800
+#define CONFIG_SFRBU 1
+#define CONFIG_VOLTAGE_LDO2 1800
+#define CONFIG_TZC400 1
+#define CONFIG_PMC_MCK_CLK_SAMA7G5 1
+#define CONFIG_FLEXCOM_TWI_IOSET_MAX 5
+#define CONFIG_PIO_E 1
+#define CONFIG_USART 1
+#define CONFIG_PMC_PLL_CLK_SAM9X60 1
+#define CONFIG_LED_ON_BOARD 1
+#define CONFIG_PIT64B 1
+#define CONFIG_DDR_BENCH 1
+#define CONFIG_VOLTAGE_OUT1 3300
+#define CONFIG_MCP16502_SET_VOLTAGE 1
+#define CONFIG_BUS_SPEED_200MHZ 1
+#define CONFIG_VOLTAGE_OUT2 1350
+#define CONFIG_VOLTAGE_OUT3 1150
+#define CONFIG_VOLTAGE_OUT4 1150
+#define CONFIG_CPU_HAS_PIO4 1
+#define CONFIG_CPU_HAS_QSPI_IOSET 1
+#define CONFIG_ALLOW_CRYSTAL_24_000MHZ 1
+#define CONFIG_CPU_HAS_WDT2 1
+#define CONFIG_DISABLE_WATCHDOG 1
+#define CONFIG_MEM_CLOCK_533 1
+#define CONFIG_CPU_HAS_SCKC 1
+#define CONFIG_LINK_ADDR "0x100000"
+#define CONFIG_BANK_4 1
+#define CONFIG_MAINOSC_MEASUREMENT 1
+#define CONFIG_SDCARD 1
+#define CONFIG_HW_BANNER "\"\\n\\nAT91Bootstrap \" AT91BOOTSTRAP_VERSION \" (\" COMPILE_TIME \")\\n\\n\""
+#define CONFIG_CPU_HAS_DWDT 1
+#define CONFIG_JUMP_ADDR "0x66f00000"
+#define CONFIG_UMCTL2 1
+#define CONFIG_MACH_TYPE "9999"
+#define CONFIG_LED_B_PIN 20
+#define CONFIG_CPU_HAS_QSPI 1
+#define CONFIG_CPU_HAS_FLEXCOM0 1
+#define CONFIG_LED_G_PIN 13
+#define CONFIG_CPU_HAS_FLEXCOM1 1
+#define CONFIG_CPU_HAS_FLEXCOM2 1
+#define CONFIG_CPU_HAS_FLEXCOM3 1
+#define CONFIG_CPU_HAS_FLEXCOM4 1
+#define CONFIG_CRYSTAL_24_000MHZ 1
+#define CONFIG_CPU_HAS_FLEXCOM5 1
+#define CONFIG_CPU_HAS_FLEXCOM6 1
+#define CONFIG_CPU_HAS_FLEXCOM7 1
+#define CONFIG_PMC_V3 1
+#define CONFIG_CPU_HAS_FLEXCOM8 1
+#define CONFIG_CPU_HAS_FLEXCOM9 1
+#define CONFIG_QSPI_BUS_MAX 1
+#define CONFIG_LED_R_PIN 8
+#define CONFIG_DEVICENAME "sama7g5"
+#define CONFIG_CPU_V7 1
+#define CONFIG_CPU_HAS_SDHC0 1
+#define CONFIG_MATRIX 1
+#define CONFIG_SAMA7G5 1
+#define CONFIG_CPU_HAS_SDHC1 1
+#define CONFIG_DDR_AS4C256M16D3LC_12BCNTR 1
+#define CONFIG_CPU_HAS_SDHC2 1
+#define CONFIG_MEMORY "sdcard"
+#define CONFIG_MCP16502 1
+#define CONFIG_IMAGE_NAME "u-boot.bin"
+#define CONFIG_ALLOW_CPU_CLK_600MHZ 1
+#define CONFIG_ALLOW_CPU_CLK_800MHZ 1
+#define CONFIG_PIO 1
+#define CONFIG_CONSOLE_INDEX 17
+#define CONFIG_CPU_HAS_PMECC 1
+#define CONFIG_LOAD_AND_JUMP 1
+#define CONFIG_CPU_HAS_XDMAC 1
+#define CONFIG_BACKUP_VDDIN33 1
+#define CONFIG_CPU_HAS_FLEXCOM10 1
+#define CONFIG_DEBUG_INFO 1
+#define CONFIG_CPU_HAS_FLEXCOM11 1
+#define CONFIG_TWI 1
+#define CONFIG_LED_B_ON_PIOD 1
+#define CONFIG_LED_G_ON_PIOA 1
@@ -367,7 +367,7 @@ void at91_qspi_hw_init(void)
 
 #endif	/* #ifdef CONFIG_DATAFLASH */
 
-#ifdef CONFIG_SDCARD
+#ifdef CONFIG_MEDIA_SDCARD
 #ifdef CONFIG_OF_LIBFDT
 void at91_board_set_dtb_name(char *of_name)
 {
@@ -427,7 +427,7 @@ void at91_sdhc_hw_init(void)
 				 GCK_CSS_PLLA_CLK,
 				 ATMEL_SDHC_GCKDIV_VALUE);
 }
-#endif /* #ifdef CONFIG_SDCARD */
+#endif /* #ifdef CONFIG_MEDIA_SDCARD */
 
 #ifdef CONFIG_NANDFLASH
 void nandflash_hw_init(void)
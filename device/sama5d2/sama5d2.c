@@ -763,7 +763,7 @@ void nandflash_hw_init(void)
 }
 #endif /* CONFIG_NANDFLASH */
 
-#ifdef CONFIG_SDCARD
+#ifdef CONFIG_MEDIA_SDCARD
 #ifdef CONFIG_OF_LIBFDT
 void at91_board_set_dtb_name(char *of_name)
 {
@@ -140,6 +140,10 @@
 #define CONFIG_SYS_ID_SDHC	AT91C_ID_SDMMC1
 #endif
 
+/* Generic clock sources for the SDMMC, the one set up at init first */
+#define CONFIG_SYS_SDHC_GCK_SOURCES	\
+	{ GCK_CSS_UPLL_CLK, GCK_CSS_PLLA_CLK, GCK_CSS_MCK_CLK, GCK_CSS_MAIN_CLK }
+
 /*
  * XDMAC Settings
  */
@@ -307,7 +307,7 @@ void at91_spi0_hw_init(void)
 }
 #endif /* #ifdef CONFIG_DATAFLASH */
 
-#ifdef CONFIG_SDCARD
+#ifdef CONFIG_MEDIA_SDCARD
 #ifdef CONFIG_OF_LIBFDT
 void at91_board_set_dtb_name(char *of_name)
 {
@@ -418,7 +418,7 @@ void at91_mci2_hw_init(void)
 	pmc_enable_periph_clock(AT91C_ID_HSMCI2, PMC_PERIPH_CLK_DIVIDER_NA);
 }
 #endif
-#endif /* #ifdef CONFIG_SDCARD */
+#endif /* #ifdef CONFIG_MEDIA_SDCARD */
 
 #ifdef CONFIG_FLASH
 void norflash_hw_init(void)
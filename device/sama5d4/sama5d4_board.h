@@ -192,8 +192,18 @@
  */
 #if defined(CONFIG_AT91_MCI0)
 #define CONFIG_SYS_BASE_MCI	AT91C_BASE_HSMCI0
+#define CONFIG_SYS_MCI_XDMAC_PERID	0
 #elif defined(CONFIG_AT91_MCI1)
 #define CONFIG_SYS_BASE_MCI	AT91C_BASE_HSMCI1
+#define CONFIG_SYS_MCI_XDMAC_PERID	1
+#endif
+
+/*
+ * XDMAC Settings
+ */
+#ifdef CONFIG_XDMAC
+#define CONFIG_SYS_BASE_XDMAC	AT91C_BASE_XDMAC0
+#define CONFIG_SYS_ID_XDMAC	AT91C_ID_XDMAC0
 #endif
 
 /*
@@ -22,6 +22,7 @@
 #include "umctl2.h"
 #include "watchdog.h"
 #include "timer.h"
+#include "div.h"
 #include "sdhc_cal.h"
 #include "led.h"
 #include "arch/tz_matrix.h"
@@ -568,19 +569,8 @@ static void umctl2_config_state_init()
 
 #ifdef CONFIG_DATAFLASH
 #if defined(CONFIG_QSPI)
-void at91_qspi_hw_init(void)
+static void qspi0_hw_init(void)
 {
-#if CONFIG_QSPI_BUS == 1
-	const struct pio_desc qspi_pins[] = {
-		{"QSPI1_IO0", AT91C_PIN_PB(25), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
-		{"QSPI1_IO1", AT91C_PIN_PB(24), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
-		{"QSPI1_IO2", AT91C_PIN_PB(23), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
-		{"QSPI1_IO3", AT91C_PIN_PB(22), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
-		{"QSPI1_CS", AT91C_PIN_PB(26), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
-		{"QSPI1_SCK", AT91C_PIN_PB(27), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
-		{(char *)0, 0, 0, PIO_DEFAULT, PIO_PERIPH_A},
-	};
-#else
 	const struct pio_desc qspi_pins[] = {
 		{"QSPI0_IO0", AT91C_PIN_PB(12), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
 		{"QSPI0_IO1", AT91C_PIN_PB(11), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
@@ -597,10 +587,46 @@ void at91_qspi_hw_init(void)
 		{"QSPI0_INT", AT91C_PIN_PB(21), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
 		{(char *)0, 0, 0, PIO_DEFAULT, PIO_PERIPH_A},
 	};
-#endif
+
+	pio_configure(qspi_pins);
+}
+
+static void qspi1_hw_init(void)
+{
+	const struct pio_desc qspi_pins[] = {
+		{"QSPI1_IO0", AT91C_PIN_PB(25), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
+		{"QSPI1_IO1", AT91C_PIN_PB(24), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
+		{"QSPI1_IO2", AT91C_PIN_PB(23), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
+		{"QSPI1_IO3", AT91C_PIN_PB(22), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
+		{"QSPI1_CS", AT91C_PIN_PB(26), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
+		{"QSPI1_SCK", AT91C_PIN_PB(27), 0, PIO_DRVSTR_HI, PIO_PERIPH_A},
+		{(char *)0, 0, 0, PIO_DEFAULT, PIO_PERIPH_A},
+	};
+
 	pio_configure(qspi_pins);
 }
 
+void at91_qspi_hw_init(void)
+{
+#if CONFIG_QSPI_BUS == 1
+	qspi1_hw_init();
+#else
+	qspi0_hw_init();
+#endif
+}
+
+#ifdef CONFIG_QSPI_STRIPE
+/* The second half of a striped image is on the other QSPI bus */
+void at91_qspi_stripe_hw_init(void)
+{
+#if CONFIG_QSPI_BUS == 1
+	qspi0_hw_init();
+#else
+	qspi1_hw_init();
+#endif
+}
+#endif
+
 #endif
 #endif /* CONFIG_DATAFLASH */
 
@@ -704,7 +730,7 @@ void nandflash_set_smc_timing(unsigned int timing_mode)
 }
 #endif /* CONFIG_NANDFLASH */
 
-#if defined(CONFIG_SDCARD)
+#if defined(CONFIG_MEDIA_SDCARD)
 #if defined(CONFIG_OF_LIBFDT)
 void at91_board_set_dtb_name(char *of_name)
 {
@@ -1146,6 +1172,8 @@ void hw_init(void)
 	struct pmc_pll_cfg ddrpll_config;
 	struct pmc_pll_cfg syspll_config;
 	struct pmc_pll_cfg imgpll_config;
+	unsigned int lock_ticks[PLL_ID_MAX];
+	unsigned int ticks_per_us;
 	unsigned int mck0_prescaler;
 
 	/* Switch backup area to VDDIN33. */
@@ -1166,7 +1194,7 @@ void hw_init(void)
 	matrix_configure_default_qos();
 #endif
 
-	/* Configure & Enable CPU PLL at a safe speed of 600 Mhz*/
+	/* Configure CPU PLL at a safe speed of 600 Mhz*/
 	plla_config.mul = 24; /* 25 * 24 = 600 */
 	plla_config.div = 0;
 	plla_config.count = 0x3f;
@@ -1175,19 +1203,59 @@ void hw_init(void)
 
 	mck0_prescaler = BOARD_PRESCALER_CPUPLL | AT91C_PMC_MDIV_3;
 
-	pmc_sam9x60_cfg_pll(PLL_ID_CPUPLL, &plla_config);
-
-	pmc_mck_cfg_set(0, mck0_prescaler,
-			AT91C_PMC_PRES | AT91C_PMC_MDIV | AT91C_PMC_CSS);
-
-	/* Configure & Enable SYS PLL */
+	/* Configure SYS PLL */
 	syspll_config.mul = 49; /* (49 + 1) * 24 = 1200 */
 	syspll_config.div = 2; /* Feed to PMC 1200/3 = 400 Mhz */
 	syspll_config.count = 0x3f;
 	syspll_config.fracr = 0;
 	syspll_config.acr = 0x00070010;
 	/* SYSPLL @ 1200 MHz */
-	pmc_sam9x60_cfg_pll(PLL_ID_SYSPLL, &syspll_config);
+
+	/* Configure DDR PLL */
+#if CONFIG_MEM_CLOCK == 533
+	ddrpll_config.mul = 43; /* (43 + 1) * 24 = 1056 */
+	ddrpll_config.div = 1;
+	ddrpll_config.divio = 100;
+	ddrpll_config.count = 0x3f;
+	ddrpll_config.fracr = 0x1aaaab; /* (10/24) * 2^22 to get extra 10 MHz */
+	ddrpll_config.acr = 0x00070010;
+	/* DDRPLL @ 1066 MHz */
+#endif
+#if CONFIG_MEM_CLOCK == 400
+	ddrpll_config.mul = 49; /* (49 + 1) * 24 =  1200 MHz */
+	ddrpll_config.div = 2;  /* 1200 / 3 = 400 MHz */
+	ddrpll_config.divio = 100;
+	ddrpll_config.count = 0x3f;
+	ddrpll_config.fracr = 0;
+	ddrpll_config.acr = 0x00070010;
+	/* DDRPLL @ 1200 MHz */
+#endif
+
+	/* Configure IMG PLL */
+	imgpll_config.mul = 43; /* (43 + 1) * 24 = 1056 */
+	imgpll_config.div = 3;
+	imgpll_config.divio = 3;
+	imgpll_config.count = 0x3f;
+	imgpll_config.fracr = 0x155555; /* (8/24) * 2^22 to get extra 8 MHz */
+	imgpll_config.acr = 0x00070010;
+	/* IMGPLL @ 1064 MHz */
+
+	/*
+	 * The PLLs are independent: start them all, then wait for each one
+	 * only when a MCK is switched to it. DDRPLL and IMGPLL lock while
+	 * the console and the timer are brought up.
+	 */
+	pmc_sam9x60_start_pll(PLL_ID_CPUPLL, &plla_config);
+	pmc_sam9x60_start_pll(PLL_ID_SYSPLL, &syspll_config);
+	pmc_sam9x60_start_pll(PLL_ID_DDRPLL, &ddrpll_config);
+	pmc_sam9x60_start_pll(PLL_ID_IMGPLL, &imgpll_config);
+
+	pmc_sam9x60_wait_pll(1 << PLL_ID_CPUPLL, NULL);
+
+	pmc_mck_cfg_set(0, mck0_prescaler,
+			AT91C_PMC_PRES | AT91C_PMC_MDIV | AT91C_PMC_CSS);
+
+	pmc_sam9x60_wait_pll(1 << PLL_ID_SYSPLL, NULL);
 
 	/* MCK4 @ 400 Mhz (== SYSPLL) */
 	pmc_mck_cfg_set(4, BOARD_PRESCALER_MCK4,
@@ -1220,41 +1288,17 @@ void hw_init(void)
 
 	dbg_very_loud("CA7 early uart\n");
 
-	/* Configure & Enable DDR PLL */
-#if CONFIG_MEM_CLOCK == 533
-	ddrpll_config.mul = 43; /* (43 + 1) * 24 = 1056 */
-	ddrpll_config.div = 1;
-	ddrpll_config.divio = 100;
-	ddrpll_config.count = 0x3f;
-	ddrpll_config.fracr = 0x1aaaab; /* (10/24) * 2^22 to get extra 10 MHz */
-	ddrpll_config.acr = 0x00070010;
-	/* DDRPLL @ 1066 MHz */
-#endif
-#if CONFIG_MEM_CLOCK == 400
-	ddrpll_config.mul = 49; /* (49 + 1) * 24 =  1200 MHz */
-	ddrpll_config.div = 2;  /* 1200 / 3 = 400 MHz */
-	ddrpll_config.divio = 100;
-	ddrpll_config.count = 0x3f;
-	ddrpll_config.fracr = 0;
-	ddrpll_config.acr = 0x00070010;
-	/* DDRPLL @ 1200 MHz */
-#endif
-	pmc_sam9x60_cfg_pll(PLL_ID_DDRPLL, &ddrpll_config);
+	pmc_sam9x60_wait_pll((1 << PLL_ID_DDRPLL) | (1 << PLL_ID_IMGPLL),
+			     lock_ticks);
+	ticks_per_us = div(timer_get_rate(), 1000000);
+	dbg_very_loud("PLL: lock wait DDRPLL %d us, IMGPLL %d us\n",
+		      div(lock_ticks[PLL_ID_DDRPLL], ticks_per_us),
+		      div(lock_ticks[PLL_ID_IMGPLL], ticks_per_us));
 
 	/* MCK2 @ DDRPLL/2 MHz */
 	pmc_mck_cfg_set(2, BOARD_PRESCALER_MCK2,
 			AT91C_MCR_DIV | AT91C_MCR_CSS | AT91C_MCR_EN);
 
-	/* Configure & Enable IMG PLL */
-	imgpll_config.mul = 43; /* (43 + 1) * 24 = 1056 */
-	imgpll_config.div = 3;
-	imgpll_config.divio = 3;
-	imgpll_config.count = 0x3f;
-	imgpll_config.fracr = 0x155555; /* (8/24) * 2^22 to get extra 8 MHz */
-	imgpll_config.acr = 0x00070010;
-	/* IMGPLL @ 1064 MHz */
-	pmc_sam9x60_cfg_pll(PLL_ID_IMGPLL, &imgpll_config);
-
 	/* MCK3 @ 266 MHz */
 	pmc_mck_cfg_set(3, BOARD_PRESCALER_MCK3,
 			AT91C_MCR_DIV | AT91C_MCR_CSS | AT91C_MCR_EN);
@@ -1283,39 +1327,82 @@ void hw_init(void)
 	usb_utmi_clk_fix();
 }
 
-void hw_postinit(void)
+static void cpu_clk_set(unsigned int mhz)
 {
+	static unsigned int cur_mhz = 600;
 	struct pmc_pll_cfg plla_config;
 	unsigned int mck0_prescaler;
 
-	/*  In order to run at 1000MHz CPU clock the board's PMIC
-	 *  must be able to raise the VDDCPU voltage to 1250mV
-	 *  as it is recommended in the datasheet.
-	 */
+	if (mhz == cur_mhz)
+		return;
 
-#ifdef CONFIG_CPU_CLK_800MHZ
-	plla_config.mul = 32; /* 33 * 24 = 792 */
 	plla_config.div = 0;
 	plla_config.count = 0x3f;
-	plla_config.fracr = 0x155556; /* 2^22 / 3 */
 	plla_config.acr = 0x00070010;
 
-	mck0_prescaler = BOARD_PRESCALER_CPUPLL | AT91C_PMC_MDIV_4;
-#endif
-#ifdef CONFIG_CPU_CLK_1000MHZ
-	plla_config.mul = 40; /* 41 * 24 = 984 */
-	plla_config.div = 0;
-	plla_config.count = 0x3f;
-	plla_config.fracr = 0x2AAAAB; /* 2^22  * 2 / 3 */
-	plla_config.acr = 0x00070010;
+	switch (mhz) {
+	case 800:
+		plla_config.mul = 32; /* 33 * 24 = 792 */
+		plla_config.fracr = 0x155556; /* 2^22 / 3 */
+		mck0_prescaler = BOARD_PRESCALER_CPUPLL | AT91C_PMC_MDIV_4;
+		break;
+	case 1000:
+		plla_config.mul = 40; /* 41 * 24 = 984 */
+		plla_config.fracr = 0x2AAAAB; /* 2^22  * 2 / 3 */
+		mck0_prescaler = BOARD_PRESCALER_CPUPLL | AT91C_PMC_MDIV_5;
+		break;
+	default:
+		plla_config.mul = 24; /* 25 * 24 = 600 */
+		plla_config.fracr = 0;
+		mck0_prescaler = BOARD_PRESCALER_CPUPLL | AT91C_PMC_MDIV_3;
+		mhz = 600;
+		break;
+	}
 
-	mck0_prescaler = BOARD_PRESCALER_CPUPLL | AT91C_PMC_MDIV_5;
-#endif
+	/* Keep MCK0 within its limit while CPUPLL changes */
+	if (mhz > cur_mhz)
+		pmc_mck_cfg_set(0, mck0_prescaler,
+				AT91C_PMC_PRES | AT91C_PMC_MDIV | AT91C_PMC_CSS);
 
-#ifndef CONFIG_CPU_CLK_600MHZ
 	pmc_sam9x60_cfg_pll(PLL_ID_CPUPLL, &plla_config);
 
-	pmc_mck_cfg_set(0, mck0_prescaler,
-			AT91C_PMC_PRES | AT91C_PMC_MDIV | AT91C_PMC_CSS);
+	if (mhz < cur_mhz)
+		pmc_mck_cfg_set(0, mck0_prescaler,
+				AT91C_PMC_PRES | AT91C_PMC_MDIV | AT91C_PMC_CSS);
+
+	cur_mhz = mhz;
+}
+
+static unsigned int cpu_clk_handoff(void)
+{
+#if defined(CONFIG_CPU_CLK_1000MHZ)
+	return 1000;
+#elif defined(CONFIG_CPU_CLK_800MHZ)
+	return 800;
+#else
+	return 600;
 #endif
 }
+
+void hw_postinit(void)
+{
+	/*  In order to run at 1000MHz CPU clock the board's PMIC
+	 *  must be able to raise the VDDCPU voltage to 1250mV
+	 *  as it is recommended in the datasheet.
+	 */
+
+#if defined(CONFIG_CPU_CLK_LOAD_1000MHZ)
+	cpu_clk_set(1000);
+#elif defined(CONFIG_CPU_CLK_LOAD_800MHZ)
+	cpu_clk_set(800);
+#else
+	cpu_clk_set(cpu_clk_handoff());
+#endif
+}
+
+#ifdef CONFIG_CPU_CLK_LOAD_BOOST
+void hw_postload(void)
+{
+	cpu_clk_set(cpu_clk_handoff());
+}
+#endif
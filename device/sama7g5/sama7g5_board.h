@@ -58,6 +58,9 @@
 #define	CONFIG_SYS_ID_SDHC		AT91C_ID_SDMMC1
 #endif
 
+/* Generic clock sources for the SDMMC, the one set up at init first */
+#define CONFIG_SYS_SDHC_GCK_SOURCES	{ GCK_CSS_SYSPLL_CLK, GCK_CSS_MAIN_CLK }
+
 #define CONFIG_SYS_SPI_CLOCK		AT91C_SPI_CLK
 #define CONFIG_SYS_SPI_MODE		SPI_MODE0
 
@@ -76,6 +79,20 @@
 #else
 #error "Invalid QSPI BUS was chosen"
 #endif
+
+#ifdef CONFIG_QSPI_STRIPE
+#if CONFIG_QSPI_BUS == 0
+#define	CONFIG_SYS_BASE_QSPI_STRIPE	AT91C_BASE_QSPI1
+#define	CONFIG_SYS_BASE_QSPI_STRIPE_MEM	AT91C_BASE_QSPI1_MEM
+#define CONFIG_SYS_QSPI_STRIPE_MEM_SIZE	AT91C_QSPI1_MEM_SIZE
+#define	CONFIG_SYS_ID_QSPI_STRIPE	AT91C_ID_QSPI1
+#else
+#define	CONFIG_SYS_BASE_QSPI_STRIPE	AT91C_BASE_QSPI0
+#define	CONFIG_SYS_BASE_QSPI_STRIPE_MEM	AT91C_BASE_QSPI0_MEM
+#define CONFIG_SYS_QSPI_STRIPE_MEM_SIZE	AT91C_QSPI0_MEM_SIZE
+#define	CONFIG_SYS_ID_QSPI_STRIPE	AT91C_ID_QSPI0
+#endif
+#endif
 #endif /* CONFIG_QSPI */
 
 /*
@@ -9,6 +9,9 @@
 #include "arch/at91-qspi/qspi.h"
 #include "spi_flash/spi_nor.h"
 #include "debug.h"
+#include "div.h"
+#include "fdt.h"
+#include "qspi_flash.h"
 
 #include "qspi-common.h"
 #ifdef CONFIG_QSPI_DMA_SUPPORT
@@ -106,41 +109,201 @@ void qspi_writel(u32 value, struct qspi_priv *qspi, u32 reg)
 	writel(value, qspi->reg_base + reg);
 }
 
-int qspi_loadimage(struct image_info *image)
+static const struct spi_flash_hwcaps qspi_hwcaps = {
+	.mask = (SFLASH_HWCAPS_READ_MASK |
+		 SFLASH_HWCAPS_PP_MASK),
+};
+
+static void qspi_boot_priv_init(struct qspi_priv *qspi)
 {
-	const struct spi_flash_hwcaps hwcaps = {
-		.mask = (SFLASH_HWCAPS_READ_MASK |
-			 SFLASH_HWCAPS_PP_MASK),
-	};
-	struct spi_flash flash;
-	struct qspi_priv qspi;
-	int ret;
+	memset(qspi, 0, sizeof(*qspi));
+	qspi->reg_base = CONFIG_SYS_BASE_QSPI;
+	qspi->mem = (void *)CONFIG_SYS_BASE_QSPI_MEM;
+	qspi->mmap_size = CONFIG_SYS_QSPI_MEM_SIZE;
+	qspi->id = CONFIG_SYS_ID_QSPI;
+	qspi->hw_init = at91_qspi_hw_init;
+#ifdef CONFIG_AT91_QSPI_OCTAL
+	qspi->octal = true;
+#endif
+}
 
-	memset(&qspi, 0, sizeof(qspi));
-	qspi.reg_base = CONFIG_SYS_BASE_QSPI;
-	qspi.mem = (void *)CONFIG_SYS_BASE_QSPI_MEM;
-	qspi.mmap_size = CONFIG_SYS_QSPI_MEM_SIZE;
+static int qspi_probe(struct spi_flash *flash, struct qspi_priv *qspi)
+{
+	int ret;
 
-	memset(&flash, 0, sizeof(flash));
-	flash.ops = &qspi_ops;
-	spi_flash_set_priv(&flash, &qspi);
+	memset(flash, 0, sizeof(*flash));
+	flash->ops = &qspi_ops;
+	spi_flash_set_priv(flash, qspi);
 
 	/* Init the SPI controller. */
-	ret = spi_flash_init(&flash);
+	ret = spi_flash_init(flash);
 	if (ret) {
 		dbg_info("SF: Fail to initialize spi\n");
 		return -1;
 	}
 
 	/* Probe the SPI flash memory. */
-	ret = spi_nor_probe(&flash, &hwcaps);
+	ret = spi_nor_probe(flash, &qspi_hwcaps);
 	if (ret) {
 		dbg_info("SF: Fail to probe SPI flash\n");
-		spi_flash_cleanup(&flash);
+		spi_flash_cleanup(flash);
 		return -1;
 	}
 
+	return 0;
+}
+
+#ifdef CONFIG_QSPI_STRIPE
+/*
+ * Striped layout: below CONFIG_QSPI_STRIPE_OFFSET the flash address space
+ * is the one of the boot flash. From there on, the logical addresses are
+ * split in CONFIG_QSPI_STRIPE_SIZE stripes going alternately to the boot
+ * flash and to the stripe flash, both starting at CONFIG_QSPI_STRIPE_OFFSET.
+ * scripts/qspi_stripe.py splits an image the same way.
+ */
+static struct qspi_stripe {
+	struct spi_flash	*flash[2];
+	unsigned char		*mem[2];
+} stripe;
+
+static void *qspi_memcpy_pair(void *dst0, const void *src0, int cnt0,
+			      void *dst1, const void *src1, int cnt1);
+
+static int qspi_stripe_read(struct spi_flash *flash, size_t from,
+			    size_t len, void *buf)
+{
+	unsigned char *dest = buf;
+	unsigned char *src[2];
+	unsigned int size[2];
+	unsigned int stripe_idx, off, chunk, chip, i;
+	size_t chip_off;
+
+	if (from < CONFIG_QSPI_STRIPE_OFFSET) {
+		chunk = CONFIG_QSPI_STRIPE_OFFSET - from;
+		if (chunk > len)
+			chunk = len;
+		qspi_memcpy(dest, stripe.mem[0] + from, chunk);
+		from += chunk;
+		dest += chunk;
+		len -= chunk;
+	}
+
+	/* Copy one stripe from each flash at a time, in parallel */
+	while (len) {
+		for (i = 0; i < 2; i++) {
+			size[i] = 0;
+			src[i] = NULL;
+			if (!len)
+				continue;
+
+			from -= CONFIG_QSPI_STRIPE_OFFSET;
+			stripe_idx = div(from, CONFIG_QSPI_STRIPE_SIZE);
+			off = from - stripe_idx * CONFIG_QSPI_STRIPE_SIZE;
+			from += CONFIG_QSPI_STRIPE_OFFSET;
+
+			chip = stripe_idx & 1;
+			chip_off = CONFIG_QSPI_STRIPE_OFFSET
+				+ (stripe_idx >> 1) * CONFIG_QSPI_STRIPE_SIZE
+				+ off;
+			chunk = CONFIG_QSPI_STRIPE_SIZE - off;
+			if (chunk > len)
+				chunk = len;
+
+			if (chip_off + chunk > stripe.flash[chip]->size)
+				return -1;
+
+			src[i] = stripe.mem[chip] + chip_off;
+			size[i] = chunk;
+			from += chunk;
+			len -= chunk;
+		}
+
+		qspi_memcpy_pair(dest, src[0], size[0],
+				 dest + size[0], src[1], size[1]);
+		dest += size[0] + size[1];
+	}
+
+	return 0;
+}
+
+static int qspi_stripe_setup(struct spi_flash *boot_flash,
+			     struct spi_flash *stripe_flash)
+{
+	struct qspi_priv *qspi;
+	void *mem;
+	int ret;
+
+	stripe.flash[0] = boot_flash;
+	stripe.flash[1] = stripe_flash;
+
+	/* Both flashes are read through their memory mapped window */
+	ret = qspi_xip(stripe_flash, &mem);
+	if (ret)
+		return ret;
+	stripe.mem[1] = mem;
+	qspi = spi_flash_get_priv(stripe_flash);
+	if (stripe_flash->size > qspi->mmap_size)
+		stripe_flash->size = qspi->mmap_size;
+
+	ret = qspi_xip(boot_flash, &mem);
+	if (ret)
+		return ret;
+	stripe.mem[0] = mem;
+	qspi = spi_flash_get_priv(boot_flash);
+	if (boot_flash->size > qspi->mmap_size)
+		boot_flash->size = qspi->mmap_size;
+
+	boot_flash->read = qspi_stripe_read;
+
+	return 0;
+}
+#endif /* CONFIG_QSPI_STRIPE */
+
+int qspi_loadimage(struct image_info *image)
+{
+	struct spi_flash flash;
+	struct qspi_priv qspi;
+#ifdef CONFIG_QSPI_STRIPE
+	struct spi_flash stripe_flash;
+	struct qspi_priv stripe_qspi;
+#endif
+	int ret;
+
+	qspi_boot_priv_init(&qspi);
+
+	ret = qspi_probe(&flash, &qspi);
+	if (ret)
+		return ret;
+
+#ifdef CONFIG_QSPI_STRIPE
+	memset(&stripe_qspi, 0, sizeof(stripe_qspi));
+	stripe_qspi.reg_base = CONFIG_SYS_BASE_QSPI_STRIPE;
+	stripe_qspi.mem = (void *)CONFIG_SYS_BASE_QSPI_STRIPE_MEM;
+	stripe_qspi.mmap_size = CONFIG_SYS_QSPI_STRIPE_MEM_SIZE;
+	stripe_qspi.id = CONFIG_SYS_ID_QSPI_STRIPE;
+	stripe_qspi.hw_init = at91_qspi_stripe_hw_init;
+
+	ret = qspi_probe(&stripe_flash, &stripe_qspi);
+	if (ret) {
+		spi_flash_cleanup(&flash);
+		return ret;
+	}
+
+	ret = qspi_stripe_setup(&flash, &stripe_flash);
+	if (ret) {
+		dbg_info("SF: Fail to map the striped flashes\n");
+		spi_flash_cleanup(&stripe_flash);
+		spi_flash_cleanup(&flash);
+		return ret;
+	}
+
+	ret = spi_flash_loadimage(&flash, image);
+	spi_flash_cleanup(&stripe_flash);
+
+	return ret;
+#else
 	return spi_flash_loadimage(&flash, image);
+#endif
 }
 
 int qspi_xip(struct spi_flash *flash, void **mem)
@@ -160,35 +323,45 @@ int qspi_xip(struct spi_flash *flash, void **mem)
 
 
 #define QSPID_XDMA_SIZE_THRESHOLD	32
+
+#ifdef CONFIG_QSPI_DMA_SUPPORT
+static int qspi_dma_start(struct xdmac_hwcfg *hwcfg, unsigned int cid,
+			  void *dst, const void *src, int cnt)
+{
+	struct xdmac_cfg cfg;
+	struct xdmac_transfer_cfg transfer_cfg;
+	int ret;
+
+	hwcfg->pid = 0xFF;
+	hwcfg->cid = cid;
+	hwcfg->src_is_periph = 0;
+	hwcfg->dst_is_periph = 0;
+	cfg.data_width = DMA_DATA_WIDTH_BYTE;
+	cfg.chunk_size = DMA_CHUNK_SIZE_1;
+	cfg.burst_size = DMA_MEM_BURST_16;
+	cfg.incr_saddr = 1;
+	cfg.incr_daddr = 1;
+	ret = xdmac_configure_transfer(hwcfg, &cfg);
+	if (ret)
+		return ret;
+	transfer_cfg.saddr = (void *)src;
+	transfer_cfg.daddr = (void *)dst;
+	transfer_cfg.len = cnt;
+
+	return xdmac_transfer_start(hwcfg, &transfer_cfg);
+}
+#endif
+
 void *qspi_memcpy(void *dst, const void *src, int cnt)
 {
 #ifdef CONFIG_QSPI_DMA_SUPPORT
 	struct xdmac_hwcfg hwcfg;
-	struct xdmac_cfg cfg;
-	struct xdmac_transfer_cfg transfer_cfg;
 	int ret;
 
 	if (cnt > QSPID_XDMA_SIZE_THRESHOLD) {
-		hwcfg.pid = 0xFF;
-		hwcfg.cid = 0;
-		hwcfg.src_is_periph = 0;
-		hwcfg.dst_is_periph = 0;
-		cfg.data_width = DMA_DATA_WIDTH_BYTE;
-		cfg.chunk_size = DMA_CHUNK_SIZE_1;
-		cfg.burst_size = DMA_MEM_BURST_16;
-		cfg.incr_saddr = 1;
-		cfg.incr_daddr = 1;
-		ret = xdmac_configure_transfer(&hwcfg, &cfg);
-		if (ret)
-			goto dma_stop;
-		transfer_cfg.saddr = (void *)src;
-		transfer_cfg.daddr = (void *)dst;
-		transfer_cfg.len = cnt;
-		ret = xdmac_transfer_start(&hwcfg, &transfer_cfg);
-		if (ret)
-			goto dma_stop;
-		ret = xdmac_transfer_wait_for_completion(&hwcfg);
-dma_stop:
+		ret = qspi_dma_start(&hwcfg, 0, dst, src, cnt);
+		if (!ret)
+			xdmac_transfer_wait_for_completion(&hwcfg);
 		xdmac_transfer_stop(&hwcfg);
 	} else {
 		while (cnt--)
@@ -200,4 +373,120 @@ dma_stop:
 	return dst;
 }
 
+#ifdef CONFIG_QSPI_STRIPE
+/*
+ * Copy from both QSPI memory windows at the same time, on two XDMAC
+ * channels. The channels are only stopped once both are done, as stopping
+ * one also gates the XDMAC clock.
+ */
+static void *qspi_memcpy_pair(void *dst0, const void *src0, int cnt0,
+			      void *dst1, const void *src1, int cnt1)
+{
+#ifdef CONFIG_QSPI_DMA_SUPPORT
+	struct xdmac_hwcfg hwcfg[2];
+	int ret0 = -1, ret1 = -1;
+
+	if (cnt0 > QSPID_XDMA_SIZE_THRESHOLD)
+		ret0 = qspi_dma_start(&hwcfg[0], 0, dst0, src0, cnt0);
+	if (cnt1 > QSPID_XDMA_SIZE_THRESHOLD)
+		ret1 = qspi_dma_start(&hwcfg[1], 1, dst1, src1, cnt1);
+
+	if (ret0)
+		memcpy(dst0, src0, cnt0);
+	if (ret1)
+		memcpy(dst1, src1, cnt1);
+
+	if (!ret0)
+		xdmac_transfer_wait_for_completion(&hwcfg[0]);
+	if (!ret1)
+		xdmac_transfer_wait_for_completion(&hwcfg[1]);
+
+	if (cnt0 > QSPID_XDMA_SIZE_THRESHOLD)
+		xdmac_transfer_stop(&hwcfg[0]);
+	if (cnt1 > QSPID_XDMA_SIZE_THRESHOLD)
+		xdmac_transfer_stop(&hwcfg[1]);
+#else
+	memcpy(dst0, src0, cnt0);
+	memcpy(dst1, src1, cnt1);
+#endif
+	return dst0;
+}
+#endif /* CONFIG_QSPI_STRIPE */
+
+#ifdef CONFIG_SPLIT_MEDIA
+/*
+ * Background read of the device tree for CONFIG_SPLIT_MEDIA: the blob
+ * size is taken from its header in the memory mapped window, then the
+ * XDMAC copies it while the CPU loads the kernel from the SD card. It
+ * uses another channel than qspi_memcpy().
+ */
+#define QSPI_BG_XDMAC_CID	1
+
+static struct spi_flash bg_flash;
+static struct qspi_priv bg_qspi;
+static struct xdmac_hwcfg bg_hwcfg;
+
+int qspi_dt_load_start(struct image_info *image)
+{
+	unsigned char *src;
+	void *mem;
+	int ret;
+
+	qspi_boot_priv_init(&bg_qspi);
+
+	ret = qspi_probe(&bg_flash, &bg_qspi);
+	if (ret)
+		return -1;
+
+	ret = qspi_xip(&bg_flash, &mem);
+	if (ret) {
+		dbg_info("SF: Fail to map the flash\n");
+		goto err_cleanup;
+	}
+
+	src = (unsigned char *)mem + image->of_offset;
+	if (image->of_offset >= bg_qspi.mmap_size
+	    || check_dt_blob_valid(src)) {
+		dbg_info("SF: No valid dt blob at %x\n", image->of_offset);
+		goto err_cleanup;
+	}
+
+	image->of_length = of_get_dt_total_size(src);
+	if (image->of_length > bg_qspi.mmap_size - image->of_offset) {
+		dbg_info("SF: dt blob is outside the flash window\n");
+		goto err_cleanup;
+	}
+
+	dbg_info("SF: dt blob: Copy %x bytes from %x to %x in background\n",
+		 image->of_length, image->of_offset, image->of_dest);
+
+	ret = qspi_dma_start(&bg_hwcfg, QSPI_BG_XDMAC_CID,
+			     image->of_dest, src, image->of_length);
+	if (ret) {
+		xdmac_transfer_stop(&bg_hwcfg);
+		goto err_cleanup;
+	}
+
+	return 0;
+
+err_cleanup:
+	spi_flash_cleanup(&bg_flash);
+	return -1;
+}
+
+int qspi_dt_load_wait(void)
+{
+	int ret;
+
+	ret = xdmac_transfer_wait_for_completion(&bg_hwcfg);
+	xdmac_transfer_stop(&bg_hwcfg);
+	spi_flash_cleanup(&bg_flash);
 
+	if (ret) {
+		dbg_info("** SF: DT: background copy error**\n");
+		return -1;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_SPLIT_MEDIA */
@@ -24,8 +24,16 @@ struct qspi_priv {
 	u32 pclk_rate;
 	u32 mr;
 	unsigned long mmap_size;
+	u32		id;		/* peripheral ID */
+	bool		octal;		/* octal instance, needs pad calibration */
+#ifdef CONFIG_QSPI_PCAL_CACHE
+	bool		pcal_pending;	/* calibration running behind bypass */
+#endif
+	void		(*hw_init)(void);
 };
 
 unsigned int qspi_readl(struct qspi_priv *qspi, u32 reg);
 void qspi_writel(u32 value, struct qspi_priv *qspi, u32 reg);
 void *qspi_memcpy(void *dst, const void *src, int cnt);
+struct spi_flash;
+int qspi_xip(struct spi_flash *flash, void **mem);
@@ -13,6 +13,13 @@
 
 #include "qspi-common.h"
 
+#ifdef CONFIG_QSPI_PCAL_CACHE
+#include "hardware.h"
+#include "rstc.h"
+#include "crc32.h"
+#include "arch/at91_rstc.h"
+#endif
+
 #define QSPI_TIMEOUT			1000000 /* us */
 #define QSPI_SYNC_TIMEOUT		300000  /* us */
 #define QSPI_DLLCFG_THRESHOLD_FREQ	90000000U
@@ -42,6 +49,85 @@ static const struct qspi_pcal pcal[QSPI_PCAL_ARRAY_SIZE] = {
 	{175000000, 6},
 	{200000000, 7},
 };
+
+#ifdef CONFIG_QSPI_PCAL_CACHE
+#define QSPI_PCAL_MAGIC		0x5043414c	/* "PCAL" */
+
+/*
+ * Pad calibration values converged during a previous boot, kept in the
+ * secure RAM along with the clocks they were obtained at.
+ */
+struct qspi_pcal_record {
+	u32 magic;
+	u32 pclk_rate;
+	u32 hz;
+	u32 calp;
+	u32 caln;
+	u32 crc;	/* of the fields above */
+};
+
+static struct qspi_pcal_record *qspi_pcal_record(void)
+{
+#ifdef AT91C_ID_SECURAM
+	pmc_enable_periph_clock(AT91C_ID_SECURAM, PMC_PERIPH_CLK_DIVIDER_NA);
+#endif
+
+	return (struct qspi_pcal_record *)(AT91C_BASE_SECURAM
+					   + CONFIG_QSPI_PCAL_CACHE_SECURAM_OFFSET);
+}
+
+static u32 qspi_pcal_record_crc(struct qspi_pcal_record *record)
+{
+	return crc32(0, (const unsigned char *)record,
+		     sizeof(*record) - sizeof(record->crc));
+}
+
+/*
+ * The calibration follows the voltage and the temperature of the pads,
+ * only reuse the recorded one after a reset which kept the board
+ * powered, at the same clocks. Return the PCALBP value to apply.
+ */
+static int qspi_pcal_load(struct qspi_priv *aq, u32 hz, u32 *pcalbp)
+{
+	struct qspi_pcal_record record;
+	unsigned int type = rstc_get_reset_type();
+
+	if ((type != AT91C_RSTC_RSTTYP_WATCHDOG)
+	    && (type != AT91C_RSTC_RSTTYP_SOFTWARE)
+	    && (type != AT91C_RSTC_RSTTYP_USER))
+		return -1;
+
+	memcpy(&record, qspi_pcal_record(), sizeof(record));
+
+	if ((record.magic != QSPI_PCAL_MAGIC)
+	    || (record.crc != qspi_pcal_record_crc(&record)))
+		return -1;
+
+	if ((record.pclk_rate != aq->pclk_rate) || (record.hz != hz))
+		return -1;
+
+	*pcalbp = QSPI_PCALBP_BPEN
+		  | QSPI_PCALBP_CALPBP_VAL(record.calp)
+		  | QSPI_PCALBP_CALNBP_VAL(record.caln);
+
+	return 0;
+}
+
+static void qspi_pcal_save(struct qspi_priv *aq, u32 hz, u32 pcalcfg)
+{
+	struct qspi_pcal_record record;
+
+	record.magic = QSPI_PCAL_MAGIC;
+	record.pclk_rate = aq->pclk_rate;
+	record.hz = hz;
+	record.calp = QSPI_PCALCFG_GET_CALP(pcalcfg);
+	record.caln = QSPI_PCALCFG_GET_CALN(pcalcfg);
+	record.crc = qspi_pcal_record_crc(&record);
+
+	memcpy(qspi_pcal_record(), &record, sizeof(record));
+}
+
+#endif
 #endif
 #endif
 
@@ -306,6 +392,72 @@ static int qspi_transfer(struct qspi_priv *aq,
 				       QSPI_TIMEOUT);
 }
 
+#ifdef CONFIG_QSPI_PCAL_CACHE
+/*
+ * Once the calibration started behind the recorded values is over,
+ * give the pads back to it and keep its result for the next boot.
+ * Unless wait is set, return at once while it still runs.
+ */
+static int qspi_pcal_refresh(struct qspi_priv *aq, bool wait)
+{
+	struct qspi_pcal_record record;
+	u32 status, pcalcfg, val;
+	int ret;
+
+	if (!aq->pcal_pending)
+		return 0;
+
+	if (wait) {
+		ret = qspi_readl_poll_timeout(aq->reg_base + QSPI_SR, val,
+					      !(val & QSPI_SR_CALBSY),
+					      QSPI_TIMEOUT);
+		if (ret)
+			return ret;
+	} else if (qspi_readl(aq, QSPI_SR) & QSPI_SR_CALBSY) {
+		return 0;
+	}
+
+	aq->pcal_pending = false;
+
+	/* Disable QSPI while leaving the bypass, as when it was set. */
+	status = qspi_readl(aq, QSPI_SR);
+	if (status & QSPI_SR_QSPIENS) {
+		ret = qspi_reg_sync(aq);
+		if (ret)
+			return ret;
+		qspi_writel(QSPI_CR_QSPIDIS, aq, QSPI_CR);
+	}
+
+	qspi_writel(0, aq, QSPI_PCALBP);
+
+	if (status & QSPI_SR_QSPIENS) {
+		ret = qspi_reg_sync(aq);
+		if (ret)
+			return ret;
+		qspi_writel(QSPI_CR_QSPIEN, aq, QSPI_CR);
+		ret = qspi_readl_poll_timeout(aq->reg_base + QSPI_SR, val,
+					      val & QSPI_SR_QSPIENS,
+					      QSPI_SYNC_TIMEOUT);
+		if (ret)
+			return ret;
+	}
+
+	pcalcfg = qspi_readl(aq, QSPI_PCALCFG);
+	memcpy(&record, qspi_pcal_record(), sizeof(record));
+	if ((record.calp == QSPI_PCALCFG_GET_CALP(pcalcfg))
+	    && (record.caln == QSPI_PCALCFG_GET_CALN(pcalcfg)))
+		return 0;
+
+	dbg_very_loud("QSPI: pad calibration moved to %x/%x\n",
+		      QSPI_PCALCFG_GET_CALP(pcalcfg),
+		      QSPI_PCALCFG_GET_CALN(pcalcfg));
+
+	qspi_pcal_save(aq, record.hz, pcalcfg);
+
+	return 0;
+}
+#endif
+
 static int qspi_exec(void *priv, const struct spi_flash_command *cmd)
 {
 	struct qspi_priv *aq = priv;
@@ -314,6 +466,12 @@ static int qspi_exec(void *priv, const struct spi_flash_command *cmd)
 
 	dbg_very_loud("at91-qspi: cmd->inst = %x\n", cmd->inst);
 
+#ifdef CONFIG_QSPI_PCAL_CACHE
+	err = qspi_pcal_refresh(aq, false);
+	if (err)
+		return err;
+#endif
+
 	if (cmd->addr + cmd->data_len > aq->mmap_size) {
 		dbg_info("QSPI: Address exceeds the MMIO window size\n");
 		return -1;
@@ -336,6 +494,11 @@ static int qspi_set_pad_calibration(struct qspi_priv *aq, u32 hz)
 	u32 status, val;
 	int i, ret;
 	u8 pclk_div = 0;
+#ifdef CONFIG_QSPI_PCAL_CACHE
+	u32 pcalbp;
+
+	aq->pcal_pending = false;
+#endif
 
 	for (i = 0; i < QSPI_PCAL_ARRAY_SIZE; i++) {
 		if (aq->pclk_rate <= pcal[i].pclk_rate) {
@@ -371,12 +534,32 @@ static int qspi_set_pad_calibration(struct qspi_priv *aq, u32 hz)
 		    QSPI_PCALCFG_CALCNT(2 * (aq->pclk_rate / 1000000)),
 		    aq, QSPI_PCALCFG);
 
-	/* DLL On + start calibration. */
-	qspi_writel(QSPI_CR_DLLON | QSPI_CR_STPCAL, aq, QSPI_CR);
-	ret =  qspi_readl_poll_timeout(aq->reg_base + QSPI_SR, val,
-				       (val & QSPI_SR_DLOCK) &&
-				       !(val & QSPI_SR_CALBSY),
-				       QSPI_TIMEOUT);
+#ifdef CONFIG_QSPI_PCAL_CACHE
+	/*
+	 * Drive the pads with the recorded values and let the calibration
+	 * run behind them, only the DLL lock is waited for.
+	 */
+	if (!qspi_pcal_load(aq, hz, &pcalbp)) {
+		qspi_writel(pcalbp, aq, QSPI_PCALBP);
+		qspi_writel(QSPI_CR_DLLON | QSPI_CR_STPCAL, aq, QSPI_CR);
+		ret = qspi_readl_poll_timeout(aq->reg_base + QSPI_SR, val,
+					      val & QSPI_SR_DLOCK,
+					      QSPI_TIMEOUT);
+		aq->pcal_pending = !ret;
+	} else
+#endif
+	{
+		/* DLL On + start calibration. */
+		qspi_writel(QSPI_CR_DLLON | QSPI_CR_STPCAL, aq, QSPI_CR);
+		ret =  qspi_readl_poll_timeout(aq->reg_base + QSPI_SR, val,
+					       (val & QSPI_SR_DLOCK) &&
+					       !(val & QSPI_SR_CALBSY),
+					       QSPI_TIMEOUT);
+#ifdef CONFIG_QSPI_PCAL_CACHE
+		if (!ret)
+			qspi_pcal_save(aq, hz, qspi_readl(aq, QSPI_PCALCFG));
+#endif
+	}
 
 	/* Refresh analogic blocks every 1 ms.*/
 	qspi_writel(QSPI_REFRESH_DELAY_COUNTER(hz / 1000), aq, QSPI_REFRESH);
@@ -408,18 +591,18 @@ static int qspi_set_gclk(struct qspi_priv *aq, u32 hz)
 	else
 		qspi_writel(0, aq, QSPI_DLLCFG);
 
-	pmc_enable_generic_clock(CONFIG_SYS_ID_QSPI, GCK_CSS_SYSPLL_CLK, 0);
-	max_gclk_rate = pmc_get_generic_clock(CONFIG_SYS_ID_QSPI);
-	pmc_enable_generic_clock(CONFIG_SYS_ID_QSPI, GCK_CSS_SYSPLL_CLK,
+	pmc_enable_generic_clock(aq->id, GCK_CSS_SYSPLL_CLK, 0);
+	max_gclk_rate = pmc_get_generic_clock(aq->id);
+	pmc_enable_generic_clock(aq->id, GCK_CSS_SYSPLL_CLK,
 				 div((max_gclk_rate + hz - 1), hz) - 1);
 #endif
 
 #ifdef CONFIG_SAM9X7
 	/* This QSPI GCLK is a 2x clock.*/
 	hz = hz * 2;
-	pmc_enable_generic_clock(CONFIG_SYS_ID_QSPI, GCK_CSS_PLLADIV2_CLK, 0);
-	max_gclk_rate = pmc_get_generic_clock(CONFIG_SYS_ID_QSPI);
-	pmc_enable_generic_clock(CONFIG_SYS_ID_QSPI, GCK_CSS_PLLADIV2_CLK,
+	pmc_enable_generic_clock(aq->id, GCK_CSS_PLLADIV2_CLK, 0);
+	max_gclk_rate = pmc_get_generic_clock(aq->id);
+	pmc_enable_generic_clock(aq->id, GCK_CSS_PLLADIV2_CLK,
 				 div((max_gclk_rate + hz - 1), hz) - 1);
 #endif
 	dbg_very_loud("max_gclk_rate = %u, hz = %u, div = %u\n",
@@ -440,21 +623,26 @@ static int qspi_set_freq(void *priv, u32 hz)
 
 #ifdef CONFIG_SAMA7G5
 #ifdef CONFIG_AT91_QSPI_OCTAL
-	ret = qspi_set_pad_calibration(priv, hz);
-	if (ret)
-		return ret;
-#else
-	qspi_writel(QSPI_CR_DLLON, aq, QSPI_CR);
-	ret =  qspi_readl_poll_timeout(aq->reg_base + QSPI_SR, val,
-				       val & QSPI_SR_DLOCK,
-				       QSPI_TIMEOUT);
+	if (aq->octal) {
+		ret = qspi_set_pad_calibration(priv, hz);
+		if (ret)
+			return ret;
+	} else
 #endif
+	{
+		qspi_writel(QSPI_CR_DLLON, aq, QSPI_CR);
+		ret =  qspi_readl_poll_timeout(aq->reg_base + QSPI_SR, val,
+					       val & QSPI_SR_DLOCK,
+					       QSPI_TIMEOUT);
+	}
 #endif
 
 #ifdef CONFIG_SAM9X7
 #ifdef CONFIG_AT91_QSPI_OCTAL
-	qspi_writel(QSPI_PCALCFG_DIFFPM, aq, QSPI_PCALCFG);
-	qspi_writel(QSPI_REFRESH_DELAY_COUNTER(div(hz, 1000)), aq, QSPI_REFRESH);
+	if (aq->octal) {
+		qspi_writel(QSPI_PCALCFG_DIFFPM, aq, QSPI_PCALCFG);
+		qspi_writel(QSPI_REFRESH_DELAY_COUNTER(div(hz, 1000)), aq, QSPI_REFRESH);
+	}
 #endif
 #endif
 	/* Set the QSPI controller by default in Serial Memory Mode */
@@ -475,8 +663,10 @@ static int qspi_set_freq(void *priv, u32 hz)
 	if (ret)
 		return ret;
 #ifdef CONFIG_AT91_QSPI_OCTAL
-	ret = qspi_readl_poll_timeout(aq->reg_base + QSPI_ISR, val,
-				      val & QSPI_ISR_RFRHD, QSPI_TIMEOUT);
+	if (aq->octal)
+		ret = qspi_readl_poll_timeout(aq->reg_base + QSPI_ISR, val,
+					      val & QSPI_ISR_RFRHD,
+					      QSPI_TIMEOUT);
 #endif
 	qspi_writel(0xffff, aq, QSPI_TOUT);
 
@@ -525,10 +715,10 @@ static int qspi_init(void *priv)
 	struct qspi_priv *aq = priv;
 	int ret;
 
-	at91_qspi_hw_init();
+	aq->hw_init();
 
-	pmc_enable_periph_clock(CONFIG_SYS_ID_QSPI, PMC_PERIPH_CLK_DIVIDER_NA);
-	aq->pclk_rate = pmc_periph_clock_get_rate(CONFIG_SYS_ID_QSPI);
+	pmc_enable_periph_clock(aq->id, PMC_PERIPH_CLK_DIVIDER_NA);
+	aq->pclk_rate = pmc_periph_clock_get_rate(aq->id);
 
 	ret = qspi_reg_sync(aq);
 	if (ret)
@@ -543,6 +733,11 @@ static int qspi_cleanup(void *priv)
 	struct qspi_priv *aq = priv;
 	int ret;
 
+#ifdef CONFIG_QSPI_PCAL_CACHE
+	/* A load shorter than the calibration still records its result */
+	qspi_pcal_refresh(aq, true);
+#endif
+
 	ret = qspi_reg_sync(aq);
 	if (ret)
 		return ret;
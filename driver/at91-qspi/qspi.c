@@ -74,7 +74,7 @@ static int qspi_init(void *priv)
 {
 	struct qspi_priv *qspi = priv;
 
-	at91_qspi_hw_init();
+	qspi->hw_init();
 
 	qspi_writel(QSPI_CR_QSPIDIS, qspi, QSPI_CR);
 	qspi_writel(QSPI_CR_SWRST, qspi, QSPI_CR);
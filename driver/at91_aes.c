@@ -2,6 +2,7 @@
 //
 // SPDX-License-Identifier: MIT
 
+#include "common.h"
 #include "hardware.h"
 #include "pmc.h"
 #include "arch/at91_aes.h"
@@ -47,8 +48,11 @@ static inline void aes_writeb(unsigned int reg, unsigned char value)
 }
 
 
-void at91_aes_init(void)
+void at91_aes_init(at91_aes_ctx_t *ctx, at91_aes_key_size_t key_size)
 {
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->key_size = key_size;
+
 	/* Enable peripheral clock */
 	pmc_enable_periph_clock(AT91C_ID_AES, PMC_PERIPH_CLK_DIVIDER_NA);
 
@@ -56,13 +60,15 @@ void at91_aes_init(void)
 	aes_writel(AES_CR, AES_CR_SWRST);
 }
 
-void at91_aes_cleanup(void)
+void at91_aes_cleanup(at91_aes_ctx_t *ctx)
 {
 	/* Reset AES */
 	aes_writel(AES_CR, AES_CR_SWRST);
 
 	/* Disable peripheral clock */
 	pmc_disable_periph_clock(AT91C_ID_AES);
+
+	memset(ctx, 0, sizeof(*ctx));
 }
 
 static inline void at91_aes_set_iv(const unsigned int *iv)
@@ -75,11 +81,12 @@ static inline void at91_aes_set_iv(const unsigned int *iv)
 	}
 }
 
-static inline int at91_aes_set_opmode(at91_aes_operation_t operation,
+static inline int at91_aes_get_opmode(at91_aes_operation_t operation,
 				      at91_aes_mode_t mode,
 				      at91_aes_key_size_t key_size,
 				      unsigned int *data_width,
-				      unsigned int *chunk_size)
+				      unsigned int *chunk_size,
+				      unsigned int *opmode)
 {
 	unsigned int mr = AES_MR_CKEY_PASSWD | AES_MR_SMOD_AUTO_START;
 
@@ -182,7 +189,7 @@ static inline int at91_aes_set_opmode(at91_aes_operation_t operation,
 		return -1;
 	}
 
-	aes_writel(AES_MR, mr);
+	*opmode = mr;
 	return 0;
 }
 
@@ -346,21 +353,36 @@ static inline unsigned int at91_aes_length2blocks(unsigned int data_length,
 	return (data_length >> shift) + ((data_length & mask) ? 1 : 0);
 }
 
-static int at91_aes_process(const at91_aes_params_t *params)
+/*
+ * The engine is not reset between the operations: every one of them ends
+ * with its output read back. Mode and key are only written when they
+ * change, the IV always is.
+ */
+static int at91_aes_process(at91_aes_ctx_t *ctx,
+			    const at91_aes_params_t *params)
 {
 	unsigned int data_width, chunk_size;
 	unsigned int block_size, num_blocks;
 	unsigned int is_mac = (params->operation == AT91_AES_OP_MAC);
+	unsigned int mr;
 
-	/* Reset AES */
-	aes_writel(AES_CR, AES_CR_SWRST);
-
-	if (at91_aes_set_opmode(params->operation, params->mode,
-				params->key_size, &data_width, &chunk_size))
+	if (at91_aes_get_opmode(params->operation, params->mode,
+				params->key_size, &data_width, &chunk_size,
+				&mr))
 		return -1;
 
-	if (at91_aes_set_key(params->key_size, params->key))
-		return -1;
+	if ((mr != ctx->mr) || (params->key != ctx->key)) {
+		aes_writel(AES_MR, mr);
+
+		if (at91_aes_set_key(params->key_size, params->key)) {
+			ctx->mr = 0;
+			ctx->key = NULL;
+			return -1;
+		}
+
+		ctx->mr = mr;
+		ctx->key = params->key;
+	}
 
 	if (params->mode != AT91_AES_MODE_ECB)
 		at91_aes_set_iv(params->iv);
@@ -384,11 +406,11 @@ static int at91_aes_process(const at91_aes_params_t *params)
 	return 0;
 }
 
-int at91_aes_cbc(unsigned int data_length,
+int at91_aes_cbc(at91_aes_ctx_t *ctx,
+		 unsigned int data_length,
 		 const void *input,
 		 void *output,
 		 int encrypt,
-		 at91_aes_key_size_t key_size,
 		 const unsigned int *key,
 		 const unsigned int *iv)
 {
@@ -403,57 +425,77 @@ int at91_aes_cbc(unsigned int data_length,
 	params.data_length = data_length;
 	params.input = input;
 	params.output = output;
-	params.key_size = key_size;
+	params.key_size = ctx->key_size;
 	params.key = key;
 	params.iv = iv;
 
-	return at91_aes_process(&params);
+	return at91_aes_process(ctx, &params);
 }
 
-int at91_aes_cmac(unsigned int data_length,
-		  const void *data,
-		  unsigned int *cmac,
-		  at91_aes_key_size_t key_size,
-		  const unsigned int *key)
+/* Derive the CMAC subkey K1 of key, unless it is already known */
+static int at91_aes_cmac_subkey(at91_aes_ctx_t *ctx, const unsigned int *key)
 {
 	static const unsigned int null_block[AT91_AES_BLOCK_SIZE_WORD];
-	static const unsigned int null_iv[AT91_AES_IV_SIZE_WORD];
-	unsigned int last_input[AT91_AES_BLOCK_SIZE_WORD];
-	unsigned int subkey[AT91_AES_BLOCK_SIZE_WORD];
-	const unsigned int *input = (const unsigned int *)data;
-	unsigned int num_blocks, offset;
+	unsigned char *subkey = (unsigned char *)ctx->subkey;
 	at91_aes_params_t params;
 	unsigned char carry;
 	int i; /* MUST be signed for the subkey loop */
 
-	if (!data_length || !data || !cmac || !key)
-		return -1;
+	if (ctx->cmac_key == key)
+		return 0;
 
-	/* Set common parameters once for all */
 	memset(&params, 0, sizeof(params));
-	params.key_size = key_size;
+	params.key_size = ctx->key_size;
 	params.key = key;
-
-	/* Generate the subkey */
 	params.operation = AT91_AES_OP_ENCRYPT;
 	params.mode = AT91_AES_MODE_ECB;
 	params.data_length = AT91_AES_BLOCK_SIZE_BYTE;
 	params.input = null_block;
-	params.output = subkey;
-	if (at91_aes_process(&params))
+	params.output = ctx->subkey;
+	if (at91_aes_process(ctx, &params))
 		return -1;
 
 	carry = 0;
 	for (i = AT91_AES_BLOCK_SIZE_BYTE-1; i >= 0; --i) {
 		unsigned char tmp, next_carry;
 
-		tmp = ((unsigned char *)subkey)[i];
+		tmp = subkey[i];
 		next_carry = ((tmp & 0x80) != 0);
-		((unsigned char *)subkey)[i] = (tmp << 1) | carry;
+		subkey[i] = (tmp << 1) | carry;
 		carry = next_carry;
 	}
 	carry = (0 - carry) & 0x87;
-	((unsigned char *)subkey)[AT91_AES_BLOCK_SIZE_BYTE-1] ^= carry;
+	subkey[AT91_AES_BLOCK_SIZE_BYTE-1] ^= carry;
+
+	ctx->cmac_key = key;
+
+	return 0;
+}
+
+int at91_aes_cmac(at91_aes_ctx_t *ctx,
+		  unsigned int data_length,
+		  const void *data,
+		  unsigned int *cmac,
+		  const unsigned int *key)
+{
+	static const unsigned int null_iv[AT91_AES_IV_SIZE_WORD];
+	unsigned int last_input[AT91_AES_BLOCK_SIZE_WORD];
+	const unsigned int *input = (const unsigned int *)data;
+	unsigned int num_blocks, offset;
+	at91_aes_params_t params;
+	unsigned int i;
+
+	if (!data_length || !data || !cmac || !key)
+		return -1;
+
+	/* Generate the subkey */
+	if (at91_aes_cmac_subkey(ctx, key))
+		return -1;
+
+	/* Set common parameters once for all */
+	memset(&params, 0, sizeof(params));
+	params.key_size = ctx->key_size;
+	params.key = key;
 
 	/* Process the n-1 first blocks */
 	num_blocks = at91_aes_length2blocks(data_length,
@@ -465,7 +507,7 @@ int at91_aes_cmac(unsigned int data_length,
 		params.data_length = data_length - AT91_AES_BLOCK_SIZE_BYTE;
 		params.input = data;
 		params.output = cmac;
-		if (at91_aes_process(&params))
+		if (at91_aes_process(ctx, &params))
 			return -1;
 	} else {
 		memset(cmac, 0, AT91_AES_BLOCK_SIZE_BYTE);
@@ -474,12 +516,12 @@ int at91_aes_cmac(unsigned int data_length,
 	/* Process the last block */
 	offset = (num_blocks-1) * AT91_AES_BLOCK_SIZE_WORD;
 	for (i = 0; i < AT91_AES_BLOCK_SIZE_WORD; ++i)
-		last_input[i] = input[offset + i] ^ cmac[i] ^ subkey[i];
+		last_input[i] = input[offset + i] ^ cmac[i] ^ ctx->subkey[i];
 
 	params.operation = AT91_AES_OP_ENCRYPT;
 	params.mode = AT91_AES_MODE_ECB;
 	params.data_length = AT91_AES_BLOCK_SIZE_BYTE;
 	params.input = last_input;
 	params.output = cmac;
-	return at91_aes_process(&params);
+	return at91_aes_process(ctx, &params);
 }
@@ -11,6 +11,13 @@
 #include "debug.h"
 #include "pmc.h"
 
+#ifdef CONFIG_AT91_MCI_DMA_SUPPORT
+#include "xdmac.h"
+#ifdef CONFIG_CACHES
+#include "l1cache.h"
+#endif
+#endif
+
 #define DEFAULT_SD_BLOCK_LEN		512
 #define CONFIG_SYS_DEFAULT_CLK		400000
 
@@ -212,6 +219,85 @@ static int at91_mci_read_block_data(unsigned int *data,
 	return 0;
 }
 
+#ifdef CONFIG_AT91_MCI_DMA_SUPPORT
+static struct xdmac_hwcfg mci_dma_hwcfg;
+
+static int at91_mci_dma_read_start(unsigned char *buff, unsigned int len)
+{
+	struct xdmac_cfg cfg;
+	struct xdmac_transfer_cfg transfer_cfg;
+	int ret;
+
+	mci_dma_hwcfg.pid = CONFIG_SYS_ID_XDMAC;
+	mci_dma_hwcfg.cid = 0;
+	mci_dma_hwcfg.src_is_periph = 1;
+	mci_dma_hwcfg.dst_is_periph = 0;
+	mci_dma_hwcfg.rxif = CONFIG_SYS_MCI_XDMAC_PERID;
+	cfg.data_width = DMA_DATA_WIDTH_WORD;
+	cfg.chunk_size = DMA_CHUNK_SIZE_1;
+	cfg.burst_size = DMA_MEM_BURST_16;
+	cfg.incr_saddr = 0;
+	cfg.incr_daddr = 1;
+	ret = xdmac_configure_transfer(&mci_dma_hwcfg, &cfg);
+	if (ret)
+		return ret;
+
+#ifdef CONFIG_CACHES
+	/*
+	 * Write back any dirty line of the destination now, so that
+	 * no eviction overwrites the data written by the DMA.
+	 */
+	dcache_clean_region((unsigned int)buff, (unsigned int)buff + len);
+#endif
+
+	/* one word is moved for each RXRDY request of the MCI */
+	mci_writel(MCI_DMA, AT91C_MCI_DMAEN_ENABLE | AT91C_MCI_CHKSIZE_1);
+
+	transfer_cfg.saddr = (void *)(CONFIG_SYS_BASE_MCI + MCI_RDR);
+	transfer_cfg.daddr = (void *)buff;
+	transfer_cfg.len = len >> 2;
+
+	return xdmac_transfer_start(&mci_dma_hwcfg, &transfer_cfg);
+}
+
+static void at91_mci_dma_read_stop(void)
+{
+	xdmac_transfer_stop(&mci_dma_hwcfg);
+	mci_writel(MCI_DMA, AT91C_MCI_DMAEN_DISABLE);
+}
+
+static int at91_mci_dma_read_wait(unsigned char *buff, unsigned int len)
+{
+	unsigned int status;
+	unsigned int error_check = (AT91C_MCI_DCRCE
+					| AT91C_MCI_DTOE
+					| AT91C_MCI_OVRE);
+	int ret;
+
+	/* The MCI flags the end of the data phase, or an error */
+	do {
+		status = mci_readl(MCI_SR);
+	} while ((!(status & AT91C_MCI_XFRDONE))
+			&& (!(status & error_check)));
+
+	if (status & error_check) {
+		dbg_loud("Error to read data by DMA, sr: %x\n", status);
+		at91_mci_dma_read_stop();
+		return -1;
+	}
+
+	ret = xdmac_transfer_wait_for_completion(&mci_dma_hwcfg);
+	at91_mci_dma_read_stop();
+
+#ifdef CONFIG_CACHES
+	/* Drop the lines speculatively fetched while the DMA was running */
+	dcache_invalidate_region((unsigned int)buff, (unsigned int)buff + len);
+#endif
+
+	return ret;
+}
+#endif
+
 static int at91_mci_write_data(unsigned int *data)
 {
 	unsigned int status;
@@ -274,6 +360,9 @@ static int at91_mci_send_command(struct sd_command *command, struct sd_data *dat
 	unsigned int cmdreg;
 	unsigned int error_check, status;
 	unsigned int block_len = DEFAULT_SD_BLOCK_LEN;
+#ifdef CONFIG_AT91_MCI_DMA_SUPPORT
+	unsigned int dma_len = 0;
+#endif
 	int ret = 0;
 
 	error_check = AT91C_MCI_RINDE | AT91C_MCI_RDIRE | AT91C_MCI_RENDE
@@ -308,10 +397,20 @@ static int at91_mci_send_command(struct sd_command *command, struct sd_data *dat
 		cmdreg |= (data->blocks > 1) ? AT91C_MCI_TRTYP_MULTIPLE : 0;
 	}
 
-	if (command->cmd == SD_CMD_READ_MULTIPLE_BLOCK) {
-		if (data)
+	if ((command->cmd == SD_CMD_READ_MULTIPLE_BLOCK)
+		|| (command->cmd == SD_CMD_READ_SINGLE_BLOCK)) {
+		if (data) {
 			mci_writel(MCI_BLKR, AT91C_MCI_BLKLEN(data->blocksize)
 					| AT91C_MCI_BCNT(data->blocks));
+#ifdef CONFIG_AT91_MCI_DMA_SUPPORT
+			/* The whole request is carried by one DMA transfer */
+			dma_len = data->blocks * data->blocksize;
+			if (at91_mci_dma_read_start(data->buff, dma_len)) {
+				at91_mci_dma_read_stop();
+				dma_len = 0;
+			}
+#endif
+		}
 	};
 
 	/* Set the Command Argument Register */
@@ -327,11 +426,19 @@ static int at91_mci_send_command(struct sd_command *command, struct sd_data *dat
 	/* Check error bits in the status */
 	if (status & AT91C_MCI_RTOE) {
 		dbg_loud("Cmd: %d Response Time-out\n", command->cmd);
+#ifdef CONFIG_AT91_MCI_DMA_SUPPORT
+		if (dma_len)
+			at91_mci_dma_read_stop();
+#endif
 		return ERROR_TIMEOUT;
 	}
 
 	if (status & error_check) {
 		dbg_loud("Cmd: %d, error check: %x, status: %x\n", command->cmd, error_check, status);
+#ifdef CONFIG_AT91_MCI_DMA_SUPPORT
+		if (dma_len)
+			at91_mci_dma_read_stop();
+#endif
 		return ERROR_COMM;
 	}
 
@@ -344,6 +451,11 @@ static int at91_mci_send_command(struct sd_command *command, struct sd_data *dat
 		command->resp[0] = mci_readl(MCI_RSPR);
 	}
 
+#ifdef CONFIG_AT91_MCI_DMA_SUPPORT
+	if (dma_len)
+		return at91_mci_dma_read_wait(data->buff, dma_len);
+#endif
+
 	if (data) {
 		if (data->direction == SD_DATA_DIR_RD)
 			ret = at91_mci_read_block_data((unsigned int *)data->buff, data->blocks,
@@ -372,6 +484,8 @@ int sdcard_register_at91_mci(struct sd_card *sdcard)
 
 	sdcard->host->caps_voltages = SD_OCR_VDD_32_33 | SD_OCR_VDD_33_34;
 	sdcard->host->caps_bus_width = BUS_WIDTH_1_BIT | BUS_WIDTH_4_BIT;
+	/* BCNT of MCI_BLKR is the only limit of a multiple block read */
+	sdcard->host->caps_max_blocks = 0xffff;
 
 #ifdef CONFIG_CPU_HAS_HSMCI0
 	sdcard->host->caps_high_speed = 1;
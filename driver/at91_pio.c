@@ -6,6 +6,7 @@
 #include "arch/at91_pio.h"
 #include "gpio.h"
 #include "debug.h"
+#include "string.h"
 
 static inline int pio_base_addr(unsigned int pio)
 {
@@ -67,20 +68,17 @@ static inline unsigned pin_to_mask(unsigned pin)
 }
 
 #ifdef CONFIG_CPU_HAS_PIO4
-static void pio4_set_periph(unsigned pio, unsigned mask,
-				int config, unsigned func)
+static unsigned int pio4_cfgr(int config, unsigned func)
 {
 	unsigned int value = func;
 
-	write_pio(pio, PIO_MSKR, mask);
-
 	value |= (config & PIO_PULLUP) ? AT91C_PIO_CFGR_PUEN : 0;
 	value |= (config & PIO_PULLDOWN) ? AT91C_PIO_CFGR_PDEN : 0;
 	value |= (config & PIO_DRVSTR_LO) ? AT91C_PIO_CFGR_DRVSTR_LOW : 0;
 	value |= (config & PIO_DRVSTR_ME) ? AT91C_PIO_CFGR_DRVSTR_MEDIUM : 0;
 	value |= (config & PIO_DRVSTR_HI) ? AT91C_PIO_CFGR_DRVSTR_HIGH : 0;
 
-	write_pio(pio, PIO_CFGR, value);
+	return value;
 }
 #endif
 
@@ -114,194 +112,6 @@ static void pio3_set_slewrate(unsigned pin, int config)
 }
 #endif
 
-static int pio_set_a_periph(unsigned pin, int config)
-{
-	unsigned pio = pin_to_controller(pin);
-	unsigned mask = pin_to_mask(pin);
-
-	if (pio >= AT91C_NUM_PIO)
-		return -1;
-
-	if (config & PIO_PULLUP && config & PIO_PULLDOWN)
-		return -1;
-
-#ifdef CONFIG_CPU_HAS_PIO4
-	pio4_set_periph(pio, mask, config, AT91C_PIO_CFGR_FUNC_PERIPH_A);
-#else
-	write_pio(pio, PIO_IDR, mask);
-	write_pio(pio, ((config & PIO_PULLUP) ? PIO_PPUER : PIO_PPUDR), mask);
-#ifdef CONFIG_CPU_HAS_PIO3
-	write_pio(pio, ((config & PIO_PULLDOWN) ? PIO_PPDER : PIO_PPDDR), mask);
-
-	pio3_set_drvstr(pin, config);
-	pio3_set_slewrate(pin, config);
-
-	write_pio(pio, PIO_SP1, read_pio(pio, PIO_SP1) & ~mask);
-	write_pio(pio, PIO_SP2, read_pio(pio, PIO_SP2) & ~mask);
-#else
-	write_pio(pio, PIO_ASR, mask);
-#endif
-	write_pio(pio, PIO_PDR, mask);
-#endif
-
-	return 0;
-}
-
-static int pio_set_b_periph(unsigned pin, int config)
-{
-	unsigned pio = pin_to_controller(pin);
-	unsigned mask = pin_to_mask(pin);
-
-	if (pio >= AT91C_NUM_PIO)
-		return -1;
-
-	if (config & PIO_PULLUP && config & PIO_PULLDOWN)
-		return -1;
-
-#ifdef CONFIG_CPU_HAS_PIO4
-	pio4_set_periph(pio, mask, config, AT91C_PIO_CFGR_FUNC_PERIPH_B);
-#else
-	write_pio(pio, PIO_IDR, mask);
-	write_pio(pio, ((config & PIO_PULLUP) ? PIO_PPUER : PIO_PPUDR), mask);
-#ifdef CONFIG_CPU_HAS_PIO3
-	write_pio(pio, ((config & PIO_PULLDOWN) ? PIO_PPDER : PIO_PPDDR), mask);
-
-	pio3_set_drvstr(pin, config);
-	pio3_set_slewrate(pin, config);
-
-	write_pio(pio, PIO_SP1, read_pio(pio, PIO_SP1) | mask);
-	write_pio(pio, PIO_SP2, read_pio(pio, PIO_SP2) & ~mask);
-#else
-	write_pio(pio, PIO_BSR, mask);
-#endif
-	write_pio(pio, PIO_PDR, mask);
-#endif
-
-	return 0;
-}
-
-static int pio_set_c_periph(unsigned pin, int config)
-{
-	unsigned pio = pin_to_controller(pin);
-	unsigned mask = pin_to_mask(pin);
-
-	mask = mask;
-
-	if (pio >= AT91C_NUM_PIO)
-		return -1;
-
-	if (config & PIO_PULLUP && config & PIO_PULLDOWN)
-		return -1;
-
-#ifdef CONFIG_CPU_HAS_PIO4
-	pio4_set_periph(pio, mask, config, AT91C_PIO_CFGR_FUNC_PERIPH_C);
-#elif defined CONFIG_CPU_HAS_PIO3
-	write_pio(pio, PIO_IDR, mask);
-	write_pio(pio, ((config && PIO_PULLUP) ? PIO_PPUER : PIO_PPUDR), mask);
-	write_pio(pio, ((config & PIO_PULLDOWN) ? PIO_PPDER : PIO_PPDDR), mask);
-
-	pio3_set_drvstr(pin, config);
-	pio3_set_slewrate(pin, config);
-
-	write_pio(pio, PIO_SP1, read_pio(pio, PIO_SP1) & ~mask);
-	write_pio(pio, PIO_SP2, read_pio(pio, PIO_SP2) | mask);
-	write_pio(pio, PIO_PDR, mask);
-#endif
-
-	return 0;
-}
-
-static int pio_set_d_periph(unsigned pin, int config)
-{
-	unsigned pio = pin_to_controller(pin);
-	unsigned mask = pin_to_mask(pin);
-
-	mask = mask;
-
-	if (pio >= AT91C_NUM_PIO)
-		return -1;
-
-	if (config & PIO_PULLUP && config & PIO_PULLDOWN)
-		return -1;
-
-#ifdef CONFIG_CPU_HAS_PIO4
-	pio4_set_periph(pio, mask, config, AT91C_PIO_CFGR_FUNC_PERIPH_D);
-#elif defined CONFIG_CPU_HAS_PIO3
-	write_pio(pio, PIO_IDR, mask);
-	write_pio(pio, ((config && PIO_PULLUP) ? PIO_PPUER : PIO_PPUDR), mask);
-	write_pio(pio, ((config & PIO_PULLDOWN) ? PIO_PPDER : PIO_PPDDR), mask);
-
-	pio3_set_drvstr(pin, config);
-	pio3_set_slewrate(pin, config);
-
-	write_pio(pio, PIO_SP1, read_pio(pio, PIO_SP1) | mask);
-	write_pio(pio, PIO_SP2, read_pio(pio, PIO_SP2) | mask);
-	write_pio(pio, PIO_PDR, mask);
-#endif
-
-	return 0;
-}
-
-static int pio_set_e_periph(unsigned pin, int config)
-{
-	unsigned pio = pin_to_controller(pin);
-	unsigned mask = pin_to_mask(pin);
-
-	mask = mask;
-
-	if (pio >= AT91C_NUM_PIO)
-		return -1;
-
-	if (config & PIO_PULLUP && config & PIO_PULLDOWN)
-		return -1;
-
-#ifdef CONFIG_CPU_HAS_PIO4
-	pio4_set_periph(pio, mask, config, AT91C_PIO_CFGR_FUNC_PERIPH_E);
-#endif
-
-	return 0;
-};
-
-static int pio_set_f_periph(unsigned pin, int config)
-{
-	unsigned pio = pin_to_controller(pin);
-	unsigned mask = pin_to_mask(pin);
-
-	mask = mask;
-
-	if (pio >= AT91C_NUM_PIO)
-		return -1;
-
-	if (config & PIO_PULLUP && config & PIO_PULLDOWN)
-		return -1;
-
-#ifdef CONFIG_CPU_HAS_PIO4
-	pio4_set_periph(pio, mask, config, AT91C_PIO_CFGR_FUNC_PERIPH_F);
-#endif
-
-	return 0;
-};
-
-static int pio_set_g_periph(unsigned pin, int config)
-{
-	unsigned pio = pin_to_controller(pin);
-	unsigned mask = pin_to_mask(pin);
-
-	mask = mask;
-
-	if (pio >= AT91C_NUM_PIO)
-		return -1;
-
-	if (config & PIO_PULLUP && config & PIO_PULLDOWN)
-		return -1;
-
-#ifdef CONFIG_CPU_HAS_PIO4
-	pio4_set_periph(pio, mask, config, AT91C_PIO_CFGR_FUNC_PERIPH_G);
-#endif
-
-	return 0;
-};
-
 int pio_set_gpio_input(unsigned pin, int config)
 {
 	unsigned pio = pin_to_controller(pin);
@@ -423,12 +233,208 @@ int pio_get_value(unsigned pin)
 }
 
 
+/*
+ * The peripheral pins of a pio_desc table are gathered into per-controller
+ * masks and each register is written once per controller, instead of once
+ * per pin. The pending masks are flushed before a pin already in them is
+ * set up again, so the result is the same as programming pin by pin.
+ */
+#ifdef CONFIG_CPU_HAS_PIO4
+#define PIO_BATCH_GROUPS	8
+
+/* Pins of one controller sharing the same CFGR value */
+struct pio_group {
+	unsigned int	pio;
+	unsigned int	cfgr;
+	unsigned int	mask;
+};
+
+struct pio_batch {
+	unsigned int		count;
+	struct pio_group	group[PIO_BATCH_GROUPS];
+};
+
+static void pio_batch_init(struct pio_batch *batch)
+{
+	batch->count = 0;
+}
+
+static int pio_batch_pending(struct pio_batch *batch, unsigned pin)
+{
+	unsigned pio = pin_to_controller(pin);
+	unsigned mask = pin_to_mask(pin);
+	unsigned int i;
+
+	for (i = 0; i < batch->count; i++)
+		if ((batch->group[i].pio == pio)
+			&& (batch->group[i].mask & mask))
+			return 1;
+
+	return 0;
+}
+
+static void pio_batch_flush(struct pio_batch *batch)
+{
+	unsigned int i;
+
+	for (i = 0; i < batch->count; i++) {
+		write_pio(batch->group[i].pio, PIO_MSKR, batch->group[i].mask);
+		write_pio(batch->group[i].pio, PIO_CFGR, batch->group[i].cfgr);
+	}
+
+	batch->count = 0;
+}
+
+static void pio_batch_add(struct pio_batch *batch, unsigned pin,
+			  enum pio_type type, int config)
+{
+	unsigned pio = pin_to_controller(pin);
+	unsigned int cfgr;
+	unsigned int i;
+
+	/* PIO_PERIPH_A..G map to AT91C_PIO_CFGR_FUNC_PERIPH_A..G */
+	cfgr = pio4_cfgr(config, AT91C_PIO_CFGR_FUNC_PERIPH_A + type);
+
+	for (i = 0; i < batch->count; i++)
+		if ((batch->group[i].pio == pio)
+			&& (batch->group[i].cfgr == cfgr))
+			break;
+
+	if (i == PIO_BATCH_GROUPS) {
+		pio_batch_flush(batch);
+		i = 0;
+	}
+
+	if (i == batch->count) {
+		batch->group[i].pio = pio;
+		batch->group[i].cfgr = cfgr;
+		batch->group[i].mask = 0;
+		batch->count++;
+	}
+
+	batch->group[i].mask |= pin_to_mask(pin);
+}
+#else
+struct pio_masks {
+	unsigned int	periph;		/* handed over to a peripheral */
+	unsigned int	pullup;
+#ifdef CONFIG_CPU_HAS_PIO3
+	unsigned int	pulldown;
+	unsigned int	drvstr_hi;
+	unsigned int	drvstr_lo;
+	unsigned int	slewrate;
+	unsigned int	sp1;
+	unsigned int	sp2;
+#else
+	unsigned int	periph_b;
+#endif
+};
+
+struct pio_batch {
+	struct pio_masks	pio[AT91C_NUM_PIO];
+};
+
+static void pio_batch_init(struct pio_batch *batch)
+{
+	memset(batch, 0, sizeof(*batch));
+}
+
+static int pio_batch_pending(struct pio_batch *batch, unsigned pin)
+{
+	return (batch->pio[pin_to_controller(pin)].periph
+		& pin_to_mask(pin)) != 0;
+}
+
+static void pio_batch_flush(struct pio_batch *batch)
+{
+	struct pio_masks *masks;
+	unsigned int pio;
+
+	for (pio = 0; pio < AT91C_NUM_PIO; pio++) {
+		masks = &batch->pio[pio];
+		if (!masks->periph)
+			continue;
+
+		write_pio(pio, PIO_IDR, masks->periph);
+		if (masks->pullup)
+			write_pio(pio, PIO_PPUER, masks->pullup);
+		if (masks->periph & ~masks->pullup)
+			write_pio(pio, PIO_PPUDR,
+				  masks->periph & ~masks->pullup);
+#ifdef CONFIG_CPU_HAS_PIO3
+		if (masks->pulldown)
+			write_pio(pio, PIO_PPDER, masks->pulldown);
+		if (masks->periph & ~masks->pulldown)
+			write_pio(pio, PIO_PPDDR,
+				  masks->periph & ~masks->pulldown);
+
+		if (masks->drvstr_hi | masks->drvstr_lo)
+			write_pio(pio, PIO_DRIVER1,
+				  (read_pio(pio, PIO_DRIVER1)
+				   | masks->drvstr_hi) & ~masks->drvstr_lo);
+		if (masks->slewrate)
+			write_pio(pio, PIO_SLEWR,
+				  read_pio(pio, PIO_SLEWR) | masks->slewrate);
+
+		write_pio(pio, PIO_SP1, (read_pio(pio, PIO_SP1)
+				& ~masks->periph) | masks->sp1);
+		write_pio(pio, PIO_SP2, (read_pio(pio, PIO_SP2)
+				& ~masks->periph) | masks->sp2);
+#else
+		if (masks->periph & ~masks->periph_b)
+			write_pio(pio, PIO_ASR,
+				  masks->periph & ~masks->periph_b);
+		if (masks->periph_b)
+			write_pio(pio, PIO_BSR, masks->periph_b);
+#endif
+		write_pio(pio, PIO_PDR, masks->periph);
+	}
+
+	pio_batch_init(batch);
+}
+
+static void pio_batch_add(struct pio_batch *batch, unsigned pin,
+			  enum pio_type type, int config)
+{
+	struct pio_masks *masks = &batch->pio[pin_to_controller(pin)];
+	unsigned mask = pin_to_mask(pin);
+
+#ifdef CONFIG_CPU_HAS_PIO3
+	if (type > PIO_PERIPH_D)
+		return;
+
+	masks->pulldown |= (config & PIO_PULLDOWN) ? mask : 0;
+
+	if (config & PIO_DRVSTR_HI)
+		masks->drvstr_hi |= mask;
+	else if (config & PIO_DRVSTR_LO)
+		masks->drvstr_lo |= mask;
+
+	masks->slewrate |= (config & PIO_SLEWR_CTRL) ? mask : 0;
+
+	/* SP1/SP2 select A (0/0), B (1/0), C (0/1) or D (1/1) */
+	masks->sp1 |= (type == PIO_PERIPH_B || type == PIO_PERIPH_D) ? mask : 0;
+	masks->sp2 |= (type == PIO_PERIPH_C || type == PIO_PERIPH_D) ? mask : 0;
+#else
+	if (type > PIO_PERIPH_B)
+		return;
+
+	masks->periph_b |= (type == PIO_PERIPH_B) ? mask : 0;
+#endif
+	masks->pullup |= (config & PIO_PULLUP) ? mask : 0;
+	masks->periph |= mask;
+}
+#endif
+
 int pio_configure(const struct pio_desc *pio_desc)
 {
+	struct pio_batch batch;
 	unsigned pio, pin = 0;
 
 	if (pio_desc == 0) return 0;
 
+	pio_batch_init(&batch);
+
 	/*
 	 * Sets all the pio muxing of the corresponding device as defined
 	 * in its platform_data struct
@@ -436,28 +442,19 @@ int pio_configure(const struct pio_desc *pio_desc)
 	while (pio_desc->pin_name) {
 		pio = pin_to_controller(pio_desc->pin_num);
 		if (pio >= AT91C_NUM_PIO) {
-			return 0;
-		} else if (pio_desc->type == PIO_PERIPH_A) {
-			pio_set_a_periph(pio_desc->pin_num,
-						pio_desc->attribute);
-		} else if (pio_desc->type == PIO_PERIPH_B) {
-			pio_set_b_periph(pio_desc->pin_num,
-						pio_desc->attribute);
-		} else if (pio_desc->type == PIO_PERIPH_C) {
-			pio_set_c_periph(pio_desc->pin_num,
-						pio_desc->attribute);
-		} else if (pio_desc->type == PIO_PERIPH_D) {
-			pio_set_d_periph(pio_desc->pin_num,
-						pio_desc->attribute);
-		} else if (pio_desc->type == PIO_PERIPH_E) {
-			pio_set_e_periph(pio_desc->pin_num,
-						pio_desc->attribute);
-		} else if (pio_desc->type == PIO_PERIPH_F) {
-			pio_set_f_periph(pio_desc->pin_num,
-						pio_desc->attribute);
-		} else if (pio_desc->type == PIO_PERIPH_G) {
-			pio_set_g_periph(pio_desc->pin_num,
-						pio_desc->attribute);
+			pin = 0;
+			break;
+		}
+
+		if (pio_batch_pending(&batch, pio_desc->pin_num))
+			pio_batch_flush(&batch);
+
+		if (pio_desc->type <= PIO_PERIPH_G) {
+			if (!(pio_desc->attribute & PIO_PULLUP
+				&& pio_desc->attribute & PIO_PULLDOWN))
+				pio_batch_add(&batch, pio_desc->pin_num,
+					      pio_desc->type,
+					      pio_desc->attribute);
 		} else if (pio_desc->type == PIO_INPUT) {
 			pio_set_gpio_input(pio_desc->pin_num,
 						pio_desc->attribute);
@@ -466,12 +463,15 @@ int pio_configure(const struct pio_desc *pio_desc)
 						pio_desc->attribute,
 						pio_desc->default_value);
 		} else {
-			return 0;
+			pin = 0;
+			break;
 		}
-		
+
 		++pin;
 		++pio_desc;
 	}
 
+	pio_batch_flush(&batch);
+
 	return pin;
 }
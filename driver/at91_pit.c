@@ -46,6 +46,20 @@ static unsigned int at91_get_pit_value(void)
 	return(pit_readl(PIT_PIIR));
 }
 
+unsigned int timer_get_ticks(void)
+{
+	return at91_get_pit_value();
+}
+
+/* The PIT counts at MCK / 16 */
+unsigned int timer_get_rate(void)
+{
+	if (pmc_mck_check_h32mxdiv())
+		return (MASTER_CLOCK / 2) / 16;
+	else
+		return MASTER_CLOCK / 16;
+}
+
 /* Because the below statement is used in the function:
  *	((MASTER_CLOCK >> 10) * usec) is used,
  * to our 32-bit system. the argu "usec" maximum value is:
@@ -2,8 +2,6 @@
 //
 // SPDX-License-Identifier: MIT
 
-#ifdef CONFIG_RSTC
-
 #include "common.h"
 #include "hardware.h"
 #include "rstc.h"
@@ -19,6 +17,14 @@ static inline unsigned int rstc_read(unsigned int offset)
 	return readl(AT91C_BASE_RSTC + offset);
 }
 
+/* Cause of the last reset, one of AT91C_RSTC_RSTTYP_* */
+unsigned int rstc_get_reset_type(void)
+{
+	return rstc_read(RSTC_RSR) & AT91C_RSTC_RSTTYP;
+}
+
+#ifdef CONFIG_RSTC
+
 /*
  * The external reset is asserted during a time of 2^(ERSTL+1) Slow Clock cycles
  * the external reset length is 15ms (1/32768 * (2 ^ 9).
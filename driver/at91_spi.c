@@ -111,6 +111,50 @@ unsigned int at91_spi_read_spi(void)
 	return spi_readl(SPI_RDR) & 0xffff;
 }
 
+/*
+ * Clock len bytes in. The next dummy byte is queued in TDR before the
+ * previous one is read back, so that the bus does not idle between the
+ * bytes; RDR must then be emptied within the time of one byte. Reading
+ * SR clears OVRES, so every status read is accumulated and an overrun
+ * anywhere in the transfer is reported at its end.
+ */
+static unsigned int spi_wait_status(unsigned int flag, unsigned int *status)
+{
+	unsigned int sr;
+
+	do {
+		sr = spi_readl(SPI_SR);
+		*status |= sr;
+	} while ((sr & flag) == 0);
+
+	return sr;
+}
+
+int at91_spi_read_data(unsigned char *data, unsigned int len)
+{
+	unsigned int status = 0;
+
+	if (!len)
+		return 0;
+
+	spi_wait_status(AT91C_SPI_TDRE, &status);
+	spi_writel(SPI_TDR, 0);
+
+	while (--len) {
+		spi_wait_status(AT91C_SPI_TDRE, &status);
+		spi_writel(SPI_TDR, 0);
+		spi_wait_status(AT91C_SPI_RDRF, &status);
+		*data++ = spi_readl(SPI_RDR);
+	}
+
+	spi_wait_status(AT91C_SPI_RDRF, &status);
+	*data = spi_readl(SPI_RDR);
+
+	status |= spi_readl(SPI_SR);
+
+	return (status & AT91C_SPI_OVRES) ? -1 : 0;
+}
+
 unsigned int at91_spi_read_sr(void)
 {
 	return spi_readl(SPI_SR);
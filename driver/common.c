@@ -9,12 +9,13 @@
 #include "flash.h"
 #include "string.h"
 #include "usart.h"
+#include "debug.h"
 
 #ifdef CONFIG_LOAD_SW
 load_function load_image;
 #endif
 
-#ifdef CONFIG_SDCARD
+#ifdef CONFIG_MEDIA_SDCARD
 char filename[FILENAME_BUF_LEN];
 #ifdef CONFIG_OF_LIBFDT
 char of_filename[FILENAME_BUF_LEN];
@@ -27,9 +28,96 @@ char cmdline_args[CMDLINE_BUF_LEN];
 
 #ifdef CONFIG_LOAD_SW
 
+#ifdef CONFIG_MEDIA_FALLBACK
+/* Boot information the ROM code leaves in r4, saved by crt0_gnu.S */
+unsigned int rom_boot_info;
+
+#define ROM_BOOT_FROM_MASK	0xf
+#define ROM_BOOT_FROM_SPI	0
+#define ROM_BOOT_FROM_MCI	1
+#define ROM_BOOT_FROM_SMC	2
+#define ROM_BOOT_FROM_QSPI	4
+#define ROM_BOOT_FROM_NONE	0xff
+
+struct boot_media {
+	unsigned int	rom_id;
+	unsigned int	rom_id_alt;
+	char		*name;
+	load_function	load;
+};
+
+/* The memory selected in the configuration comes first */
+static const struct boot_media media_table[] = {
+#if defined(CONFIG_DATAFLASH)
+	{ ROM_BOOT_FROM_SPI, ROM_BOOT_FROM_QSPI, "SF: ", &load_dataflash },
+#elif defined(CONFIG_FLASH)
+	{ ROM_BOOT_FROM_NONE, ROM_BOOT_FROM_NONE, "FLASH: ", &load_norflash },
+#elif defined(CONFIG_NANDFLASH)
+	{ ROM_BOOT_FROM_SMC, ROM_BOOT_FROM_NONE, "NAND: ", &load_nandflash },
+#endif
+#ifdef CONFIG_MEDIA_SDCARD
+	{ ROM_BOOT_FROM_MCI, ROM_BOOT_FROM_NONE, "SD/MMC: ", &load_sdcard },
+#endif
+};
+
+static const struct boot_media *media_loaded;
+
+static int media_is_boot_source(const struct boot_media *media)
+{
+	unsigned int boot_from = rom_boot_info & ROM_BOOT_FROM_MASK;
+
+	return (media->rom_id == boot_from) || (media->rom_id_alt == boot_from);
+}
+
+static int media_try_load(const struct boot_media *media,
+			  struct image_info *image)
+{
+	dbg_info("%sTrying to load image\n", media->name);
+
+	if ((*media->load)(image))
+		return -1;
+
+	media_loaded = media;
+
+	return 0;
+}
+
+/*
+ * The medium the ROM code booted from is tried first, so an absent
+ * device is only probed once that one has failed.
+ */
+static int load_media_chain(struct image_info *image)
+{
+	const struct boot_media *boot_media = NULL;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(media_table); i++) {
+		if (media_is_boot_source(&media_table[i])) {
+			boot_media = &media_table[i];
+			break;
+		}
+	}
+
+	if (boot_media && !media_try_load(boot_media, image))
+		return 0;
+
+	for (i = 0; i < ARRAY_SIZE(media_table); i++) {
+		if (&media_table[i] == boot_media)
+			continue;
+
+		if (!media_try_load(&media_table[i], image))
+			return 0;
+	}
+
+	return -1;
+}
+#endif /* CONFIG_MEDIA_FALLBACK */
+
 load_function get_image_load_func(void)
 {
-#if defined(CONFIG_DATAFLASH)
+#if defined(CONFIG_MEDIA_FALLBACK)
+	return &load_media_chain;
+#elif defined(CONFIG_DATAFLASH)
 	return &load_dataflash;
 #elif defined(CONFIG_FLASH)
 	return &load_norflash;
@@ -58,7 +146,7 @@ unsigned int get_image_load_offset(unsigned int addr)
 void init_load_image(struct image_info *image)
 {
 	memset(image,		0, sizeof(*image));
-#ifdef CONFIG_SDCARD
+#ifdef CONFIG_MEDIA_SDCARD
 	memset(filename,	0, FILENAME_BUF_LEN);
 #ifdef CONFIG_OF_LIBFDT
 	memset(of_filename,	0, FILENAME_BUF_LEN);
@@ -83,7 +171,7 @@ void init_load_image(struct image_info *image)
 	image->of_dest = (unsigned char *)OF_ADDRESS;
 #endif
 
-#ifdef CONFIG_SDCARD
+#ifdef CONFIG_MEDIA_SDCARD
 	image->filename = filename;
 	strcpy(image->filename, IMAGE_NAME);
 #ifdef CONFIG_OF_LIBFDT
@@ -110,6 +198,10 @@ void load_image_done(int retval)
 
 #ifndef CONFIG_LOAD_SW
 	media = "NONE: ";
+#elif defined(CONFIG_MEDIA_FALLBACK)
+	media = media_loaded ? media_loaded->name : NULL;
+#elif defined(CONFIG_SPLIT_MEDIA)
+	media = "SF + SD/MMC: ";
 #elif defined(CONFIG_FLASH)
 	media = "FLASH: ";
 #elif defined(CONFIG_NANDFLASH)
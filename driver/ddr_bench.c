@@ -0,0 +1,260 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "common.h"
+#include "hardware.h"
+#include "board.h"
+#include "timer.h"
+#include "div.h"
+#include "debug.h"
+#include "ddr_bench.h"
+
+#ifdef CONFIG_XDMAC
+#include "xdmac.h"
+#endif
+
+#if defined(CONFIG_SAMA7G5) && defined(CONFIG_MATRIX)
+#include "matrix.h"
+#endif
+
+#ifdef CONFIG_CACHES
+#include "l1cache.h"
+#include "mmu.h"
+#endif
+
+/*
+ * The area is split in two halves, the copy tests move the first one
+ * into the second one. The pointer chase visits one word per node, the
+ * nodes being far enough apart not to share a cache line.
+ */
+#define BENCH_BASE		((unsigned int *)CONFIG_DDR_BENCH_ADDR)
+#define BENCH_SIZE		CONFIG_DDR_BENCH_SIZE
+#define BENCH_HALF		(BENCH_SIZE / 2)
+
+#define CHASE_NODE_SIZE		256
+#define CHASE_NODES		(BENCH_SIZE / CHASE_NODE_SIZE)
+#define CHASE_ROUNDS		4
+
+static unsigned int ticks_per_ms;
+
+static unsigned int ticks_to_us(unsigned int ticks)
+{
+	unsigned int ms, rem;
+
+	division(ticks, ticks_per_ms, &ms, &rem);
+
+	return ms * 1000 + div(rem * 1000, ticks_per_ms);
+}
+
+static void bench_print(const char *name, unsigned int bytes,
+			unsigned int ticks)
+{
+	unsigned int us = ticks_to_us(ticks);
+
+	if (!us)
+		us = 1;
+
+	dbg_printf("  %s\t%d MB/s\t(%d us)\n", name, div(bytes, us), us);
+}
+
+static unsigned int bench_write(void)
+{
+	volatile unsigned int *p = BENCH_BASE;
+	volatile unsigned int *end = BENCH_BASE + BENCH_SIZE / 4;
+	unsigned int start = timer_get_ticks();
+
+	while (p < end) {
+		p[0] = 0; p[1] = 0; p[2] = 0; p[3] = 0;
+		p[4] = 0; p[5] = 0; p[6] = 0; p[7] = 0;
+		p += 8;
+	}
+
+	return timer_get_ticks() - start;
+}
+
+static unsigned int bench_read(void)
+{
+	volatile unsigned int *p = BENCH_BASE;
+	volatile unsigned int *end = BENCH_BASE + BENCH_SIZE / 4;
+	unsigned int start = timer_get_ticks();
+	unsigned int sum = 0;
+
+	while (p < end) {
+		sum ^= p[0]; sum ^= p[1]; sum ^= p[2]; sum ^= p[3];
+		sum ^= p[4]; sum ^= p[5]; sum ^= p[6]; sum ^= p[7];
+		p += 8;
+	}
+
+	start = timer_get_ticks() - start;
+
+	/* keep the loads */
+	*BENCH_BASE = sum;
+
+	return start;
+}
+
+static unsigned int bench_copy(void)
+{
+	volatile unsigned int *src = BENCH_BASE;
+	volatile unsigned int *dst = BENCH_BASE + BENCH_HALF / 4;
+	volatile unsigned int *end = dst;
+	unsigned int start = timer_get_ticks();
+
+	while (src < end) {
+		dst[0] = src[0]; dst[1] = src[1];
+		dst[2] = src[2]; dst[3] = src[3];
+		dst[4] = src[4]; dst[5] = src[5];
+		dst[6] = src[6]; dst[7] = src[7];
+		src += 8;
+		dst += 8;
+	}
+
+	return timer_get_ticks() - start;
+}
+
+#ifdef CONFIG_XDMAC
+/* Return the copy time in ticks, or -1 if the XDMAC failed */
+static int bench_dma_copy(void)
+{
+	struct xdmac_hwcfg hwcfg;
+	struct xdmac_cfg cfg;
+	struct xdmac_transfer_cfg transfer_cfg;
+	unsigned int start;
+	int ret;
+
+#ifdef CONFIG_CACHES
+	dcache_clean();
+	dcache_invalidate();
+#endif
+
+	hwcfg.pid = 0xFF;
+	hwcfg.cid = 0;
+	hwcfg.src_is_periph = 0;
+	hwcfg.dst_is_periph = 0;
+	cfg.data_width = DMA_DATA_WIDTH_WORD;
+	cfg.chunk_size = DMA_CHUNK_SIZE_1;
+	cfg.burst_size = DMA_MEM_BURST_16;
+	cfg.incr_saddr = 1;
+	cfg.incr_daddr = 1;
+	ret = xdmac_configure_transfer(&hwcfg, &cfg);
+	if (ret)
+		goto dma_stop;
+
+	transfer_cfg.saddr = (void *)BENCH_BASE;
+	transfer_cfg.daddr = (void *)(BENCH_BASE + BENCH_HALF / 4);
+	transfer_cfg.len = BENCH_HALF / 4;
+
+	start = timer_get_ticks();
+	ret = xdmac_transfer_start(&hwcfg, &transfer_cfg);
+	if (!ret)
+		ret = xdmac_transfer_wait_for_completion(&hwcfg);
+	start = timer_get_ticks() - start;
+
+dma_stop:
+	xdmac_transfer_stop(&hwcfg);
+
+	return ret ? -1 : (int)start;
+}
+#endif
+
+/*
+ * Link the nodes in the order of a full period LCG, so that neither
+ * the next line nor a constant stride can be prefetched.
+ */
+static void chase_init(void)
+{
+	unsigned int i, next;
+
+	for (i = 0; i < CHASE_NODES; i++) {
+		next = (i * 5 + 1) & (CHASE_NODES - 1);
+		BENCH_BASE[i * CHASE_NODE_SIZE / 4] =
+			(unsigned int)&BENCH_BASE[next * CHASE_NODE_SIZE / 4];
+	}
+}
+
+static void bench_latency(void)
+{
+	unsigned int *node = BENCH_BASE;
+	unsigned int loads = CHASE_NODES * CHASE_ROUNDS;
+	unsigned int start, us, i;
+
+	chase_init();
+
+	start = timer_get_ticks();
+	for (i = 0; i < loads; i++)
+		node = *(unsigned int * volatile *)node;
+	us = ticks_to_us(timer_get_ticks() - start);
+
+	/* keep the chain walk */
+	BENCH_BASE[1] = (unsigned int)node;
+
+	dbg_printf("  latency\t%d ns\n", div(us * 1000, loads));
+}
+
+static void bench_run(const char *mode, const char *qos)
+{
+#ifdef CONFIG_XDMAC
+	int ticks;
+#endif
+
+	dbg_printf("DDR bench: %s, %s\n", mode, qos);
+
+	bench_print("write", BENCH_SIZE, bench_write());
+	bench_print("read", BENCH_SIZE, bench_read());
+	bench_print("copy", BENCH_HALF, bench_copy());
+#ifdef CONFIG_XDMAC
+	ticks = bench_dma_copy();
+	if (ticks < 0)
+		dbg_printf("  dma copy\tfailed\n");
+	else
+		bench_print("dma copy", BENCH_HALF, ticks);
+#endif
+	bench_latency();
+}
+
+/*
+ * The matrix QoS can be rewritten at any time: run the table with the
+ * master priorities cleared as out of reset, then with the ones set by
+ * matrix_configure_default_qos(), which are left in place.
+ */
+static void bench_run_qos(const char *mode)
+{
+#if defined(CONFIG_SAMA7G5) && defined(CONFIG_MATRIX)
+	matrix_clear_master_qos();
+	bench_run(mode, "QoS at reset");
+
+	matrix_configure_default_qos();
+	bench_run(mode, "QoS configured");
+#else
+	bench_run(mode, "QoS as configured");
+#endif
+}
+
+void ddr_bench(void)
+{
+#ifdef CONFIG_CACHES
+	unsigned int *tlb = (unsigned int *)MMU_TABLE_BASE_ADDR;
+#endif
+
+	ticks_per_ms = div(timer_get_rate(), 1000);
+
+	dbg_printf("DDR bench: %d KB at %x, timer %d kHz\n",
+		   BENCH_SIZE >> 10, CONFIG_DDR_BENCH_ADDR, ticks_per_ms);
+
+	bench_run_qos("caches off");
+
+#ifdef CONFIG_CACHES
+	mmu_tlb_init(tlb);
+	mmu_configure(tlb);
+	mmu_enable();
+	icache_enable();
+	dcache_enable();
+
+	bench_run_qos("caches on");
+
+	icache_disable();
+	dcache_disable();
+	mmu_disable();
+#endif
+}
@@ -21,8 +21,17 @@
 #include "ddr_jedec.h"
 #elif defined(CONFIG_DDR_SET_BY_DEVICE)
 #include "ddr_device.h"
+#elif defined(CONFIG_DDR_SET_BY_TABLE)
+#include "ddram_table.h"
 #endif
 
+#if defined(CONFIG_DDR_SET_BY_TABLE)
+/* The whole register image is computed by scripts/ddr_timing.py */
+static void ddram_reg_config(struct ddramc_register *ddramc_config)
+{
+	*ddramc_config = ddramc_table;
+}
+#else
 static void ddram_reg_config(struct ddramc_register *ddramc_config)
 {
 	unsigned int type, dbw, col, row, cas, bank;
@@ -649,6 +658,7 @@ static void ddram_reg_config(struct ddramc_register *ddramc_config)
 						  );
 #endif
 }
+#endif /* CONFIG_DDR_SET_BY_TABLE */
 
 unsigned int get_ddram_size(void)
 {
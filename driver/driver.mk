@@ -36,16 +36,18 @@ COBJS-$(CONFIG_SDRAM)		+= $(DRIVERS_SRC)/sdramc.o
 COBJS-$(CONFIG_SDDRC)		+= $(DRIVERS_SRC)/sddrc.o
 COBJS-$(CONFIG_DDRC)		+= $(DRIVERS_SRC)/ddramc.o
 COBJS-$(CONFIG_UMCTL2)		+= $(DRIVERS_SRC)/umctl2.o
+COBJS-$(CONFIG_DDR_BENCH)	+= $(DRIVERS_SRC)/ddr_bench.o
 COBJS-$(CONFIG_PUBL)		+= $(DRIVERS_SRC)/publ.o
 
 COBJS-$(CONFIG_AT91_MCI)	+= $(DRIVERS_SRC)/at91_mci.o
 COBJS-$(CONFIG_SDHC)		+= $(DRIVERS_SRC)/sdhc.o
 
-COBJS-$(CONFIG_SDCARD)		+= $(DRIVERS_SRC)/mci_media.o
-COBJS-$(CONFIG_SDCARD)		+= $(DRIVERS_SRC)/sdcard.o
+COBJS-$(CONFIG_MEDIA_SDCARD)	+= $(DRIVERS_SRC)/mci_media.o
+COBJS-$(CONFIG_MEDIA_SDCARD)	+= $(DRIVERS_SRC)/sdcard.o
 
 COBJS-$(CONFIG_NANDFLASH)	+= $(DRIVERS_SRC)/nandflash.o
 COBJS-$(CONFIG_USE_PMECC)	+= $(DRIVERS_SRC)/pmecc.o
+COBJS-$(CONFIG_NANDFLASH_UBI)	+= $(DRIVERS_SRC)/ubi.o
 COBJS-$(CONFIG_ENABLE_SW_ECC) 	+= $(DRIVERS_SRC)/hamming.o
 
 COBJS-$(CONFIG_SPI_FLASH)	+= $(DRIVERS_SRC)/spi_flash/spi_flash.o
@@ -72,6 +74,7 @@ COBJS-$(CONFIG_FLASH)		+= $(DRIVERS_SRC)/flash.o
 ifeq ($(CONFIG_LOAD_SW), y)
 COBJS-$(CONFIG_LOAD_LINUX)	+= $(DRIVERS_SRC)/load_kernel.o
 COBJS-$(CONFIG_LOAD_ANDROID)	+= $(DRIVERS_SRC)/load_kernel.o
+COBJS-$(CONFIG_WARM_BOOT)	+= $(DRIVERS_SRC)/warm_boot.o
 endif
 
 COBJS-$(CONFIG_LOAD_ONE_WIRE)	+= $(DRIVERS_SRC)/ds24xx.o
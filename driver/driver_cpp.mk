@@ -136,6 +136,10 @@ CPPFLAGS += -DCONFIG_REF_CYCLE=8192
 endif
 endif
 
+ifeq ($(CONFIG_DDR_SET_BY_TABLE),y)
+CPPFLAGS += -I$(BUILDDIR)/include
+endif
+
 # Dataflash support
 ifeq ($(MEMORY),dataflash)
 CPPFLAGS += -DAT91C_SPI_CLK=$(SPI_CLK)
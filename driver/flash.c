@@ -8,6 +8,7 @@
 #include "string.h"
 #include "debug.h"
 #include "fdt.h"
+#include "secure.h"
 
 #include "debug.h"
 
@@ -43,7 +44,14 @@ int load_norflash(struct image_info *image)
 
 	norflash_hw_init();
 
-#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+#if defined(CONFIG_SECURE)
+	length = secure_image_length((const void *)image->offset,
+				     secure_image_room(image));
+	if (length == -1)
+		return -1;
+
+	image->length = length;
+#elif defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
 	length = update_image_length(image->offset, image->dest, KERNEL_IMAGE);
 	if (length == -1)
 		return -1;
@@ -96,3 +96,22 @@ void dcache_clean(void)
 	dsb();
 }
 
+void dcache_clean_region(unsigned int start, unsigned int end)
+{
+	unsigned int mva;
+
+	for (mva = start & ~(L1_CACHE_BYTES - 1); mva < end; mva += L1_CACHE_BYTES)
+		cp15_dcache_clean_mva(mva);
+
+	dsb();
+}
+
+void dcache_invalidate_region(unsigned int start, unsigned int end)
+{
+	unsigned int mva;
+
+	for (mva = start & ~(L1_CACHE_BYTES - 1); mva < end; mva += L1_CACHE_BYTES)
+		cp15_dcache_invalidate_mva(mva);
+
+	dsb();
+}
@@ -9,6 +9,7 @@
 #include "string.h"
 #include "slowclk.h"
 #include "dataflash.h"
+#include "qspi_flash.h"
 #include "ddramc.h"
 #include "nandflash.h"
 #include "optee.h"
@@ -20,6 +21,8 @@
 #include "mon.h"
 #include "tz_utils.h"
 #include "secure.h"
+#include "crc32.h"
+#include "warm_boot.h"
 
 #include "debug.h"
 
@@ -256,6 +259,95 @@ struct linux_zimage_header {
 	unsigned int	end;
 };
 
+#ifdef CONFIG_UIMAGE_CRC
+/*
+ * The data CRC is accumulated by the loaders while the image is still
+ * coming in, boot_image_setup() only has to cover what is left.
+ */
+static struct {
+	unsigned char	*base;
+	unsigned int	done;	/* bytes landed at base */
+	unsigned int	crc;	/* CRC of the data landed beyond the header */
+} uimage_crc;
+
+void uimage_crc_start(unsigned char *base)
+{
+	uimage_crc.base = base;
+	uimage_crc.done = 0;
+	uimage_crc.crc = 0;
+}
+
+void uimage_crc_update(unsigned char *buf, unsigned int len)
+{
+	struct linux_uimage_header *header
+			= (struct linux_uimage_header *)uimage_crc.base;
+	unsigned int hlen = sizeof(struct linux_uimage_header);
+	unsigned int start, end;
+
+	/* only chunks landing right after the previous one are accounted */
+	if (!uimage_crc.base || (buf != uimage_crc.base + uimage_crc.done))
+		return;
+
+	start = uimage_crc.done;
+	uimage_crc.done += len;
+	if (uimage_crc.done < hlen)
+		return;
+
+	if (swap_uint32(header->magic) != LINUX_UIMAGE_MAGIC) {
+		uimage_crc.base = NULL;
+		return;
+	}
+
+	if (start < hlen)
+		start = hlen;
+
+	end = uimage_crc.done;
+	if (end > hlen + swap_uint32(header->size))
+		end = hlen + swap_uint32(header->size);
+
+	if (end > start)
+		uimage_crc.crc = crc32(uimage_crc.crc,
+				       uimage_crc.base + start, end - start);
+}
+
+static int uimage_check_crc(struct linux_uimage_header *header)
+{
+	struct linux_uimage_header tmp;
+	unsigned char *data = (unsigned char *)header + sizeof(tmp);
+	unsigned int size = swap_uint32(header->size);
+	unsigned int crc = 0;
+	unsigned int done = 0;
+
+	memcpy(&tmp, header, sizeof(tmp));
+	tmp.header_crc = 0;
+	if (crc32(0, (unsigned char *)&tmp, sizeof(tmp))
+			!= swap_uint32(header->header_crc)) {
+		dbg_info("KERNEL: uImage header CRC error!\n");
+		return -1;
+	}
+
+	if ((uimage_crc.base == (unsigned char *)header)
+			&& (uimage_crc.done > sizeof(tmp))) {
+		crc = uimage_crc.crc;
+		done = uimage_crc.done - sizeof(tmp);
+		if (done > size)
+			done = size;
+	}
+	uimage_crc.base = NULL;
+
+	crc = crc32(crc, data + done, size - done);
+	if (crc != swap_uint32(header->data_crc)) {
+		dbg_info("KERNEL: uImage data CRC error!\n");
+		return -1;
+	}
+
+	dbg_info("KERNEL: uImage CRC OK, %d bytes checked during load\n",
+			done);
+
+	return 0;
+}
+#endif
+
 int kernel_size(unsigned char *addr)
 {
 	struct linux_uimage_header *uimage_header
@@ -307,6 +399,11 @@ static int boot_image_setup(unsigned char *addr, unsigned int *entry)
 			return -1;
 		}
 
+#ifdef CONFIG_UIMAGE_CRC
+		if (uimage_check_crc(uimage_header))
+			return -1;
+#endif
+
 		size = swap_uint32(uimage_header->size);
 		dest = swap_uint32(uimage_header->load);
 		src = (unsigned int)addr + sizeof(struct linux_uimage_header);
@@ -330,6 +427,32 @@ static int boot_image_setup(unsigned char *addr, unsigned int *entry)
 #endif /* !CONFIG_QSPI_XIP */
 #endif /* CONFIG_LINUX_IMAGE */
 
+#ifdef CONFIG_SPLIT_MEDIA
+/*
+ * The device tree is copied from the QSPI flash by the DMA while the
+ * kernel is read from the SD card.
+ */
+static int load_kernel_image(struct image_info *image)
+{
+	char *of_filename = image->of_filename;
+	int ret;
+
+	ret = qspi_dt_load_start(image);
+	if (ret)
+		return ret;
+
+	/* Keep of_dest, the card loader bounds the kernel below the blob */
+	image->of_filename = NULL;
+	ret = load_sdcard(image);
+	image->of_filename = of_filename;
+
+	/* The copy must be over before anything else uses its memory */
+	if (qspi_dt_load_wait())
+		ret = -1;
+
+	return ret;
+}
+#else
 static int load_kernel_image(struct image_info *image)
 {
 	int ret;
@@ -341,6 +464,7 @@ static int load_kernel_image(struct image_info *image)
 
 	return 0;
 }
+#endif
 
 #ifdef CONFIG_OVERRIDE_CMDLINE_FROM_EXT_FILE
 __attribute__((weak)) char *board_override_cmd_line_ext(char *cmdline_args)
@@ -362,6 +486,9 @@ int load_kernel(struct image_info *image)
 	unsigned int mach_type;
 	int ret;
 	unsigned int mem_size;
+#ifdef CONFIG_WARM_BOOT
+	int warm;
+#endif
 
 #if defined(CONFIG_SDRAM)
 	mem_size = get_sdram_size();
@@ -413,9 +540,20 @@ int load_kernel(struct image_info *image)
 	}
 	bootargs = cmdline_buf;
 
+#ifdef CONFIG_WARM_BOOT
+	warm = !warm_boot_check(image);
+	if (!warm) {
+		ret = load_kernel_image(image);
+		if (ret)
+			return ret;
+
+		warm_boot_prepare(image);
+	}
+#else
 	ret = load_kernel_image(image);
 	if (ret)
 		return ret;
+#endif
 
 #ifdef CONFIG_OVERRIDE_CMDLINE_FROM_EXT_FILE
 	bootargs = board_override_cmd_line_ext(image->cmdline_args);
@@ -447,6 +585,11 @@ int load_kernel(struct image_info *image)
 
 	mach_type = 0xffffffff;
 	r2 = (unsigned int)image->of_dest;
+
+#ifdef CONFIG_WARM_BOOT
+	if (!warm)
+		warm_boot_save(image);
+#endif
 #else
 	setup_boot_params();
 
@@ -454,6 +597,8 @@ int load_kernel(struct image_info *image)
 	r2 = (unsigned int)(AT91C_BASE_DDRCS + 0x100);
 #endif
 
+	hw_postload();
+
 	dbg_info("\nKERNEL: Starting linux kernel ..., machid: %x\n\n",
 							mach_type);
 #if defined(CONFIG_ENTER_NWD)
@@ -488,14 +488,19 @@ int matrix_configure_peri_security(unsigned int *peri_id, unsigned int size)
 }
 
 #ifdef CONFIG_SAMA5D4
+/* One bit per peripheral ID, set when the peripheral is secure */
+static unsigned int peri_security_map[(AT91C_ID_COUNTS + 31) / 32];
+/* One bit per peripheral ID, set when its clock must be kept on */
+static unsigned int peri_clk_locked_map[(AT91C_ID_COUNTS + 31) / 32];
+
 /*
- * is_peripheral_secure - tell if the peripheral is in secure mode
+ * peri_security_lookup - tell if the peripheral is in secure mode
  * @periph_id: the peripheral id that is checked
  *
  * Check security of a particular peripheral by providing its ID.
  * Note that a wrong preripheral ID leads to the "true" return code.
  */
-int is_peripheral_secure(unsigned int periph_id)
+static int peri_security_lookup(unsigned int periph_id)
 {
 	struct peri_security *peripheral_sec;
 	unsigned int mask;
@@ -524,6 +529,46 @@ int is_peripheral_secure(unsigned int periph_id)
 	return 1;
 }
 
+/* The console clock is never switched off for the Normal World */
+static int peri_clk_lock_lookup(unsigned int periph_id)
+{
+	return periph_id == AT91C_ID_USART3;
+}
+
+/*
+ * matrix_cache_peri_security - snapshot the peripheral security
+ *
+ * The Normal World cannot change SPSELR, so the security of every
+ * peripheral, and whether its clock may be switched off, is looked up
+ * once before leaving the Secure World rather than on each monitor call.
+ */
+void matrix_cache_peri_security(void)
+{
+	unsigned int id, mask;
+
+	for (id = 0; id < AT91C_ID_COUNTS; id++) {
+		mask = 1 << (id % 32);
+
+		if (peri_security_lookup(id))
+			peri_security_map[id / 32] |= mask;
+		else
+			peri_security_map[id / 32] &= ~mask;
+
+		if (peri_clk_lock_lookup(id))
+			peri_clk_locked_map[id / 32] |= mask;
+		else
+			peri_clk_locked_map[id / 32] &= ~mask;
+	}
+}
+
+int is_peripheral_secure(unsigned int periph_id)
+{
+	if (periph_id >= AT91C_ID_COUNTS)
+		return 1;
+
+	return (peri_security_map[periph_id / 32] >> (periph_id % 32)) & 1;
+}
+
 int is_sys_clk_secure(unsigned int sys_mask)
 {
 	unsigned int periph_id = sys_mask_to_per_id(sys_mask);
@@ -556,20 +601,23 @@ int is_usb_host_secure(void)
 
 int is_switching_clock_forbiden(unsigned int periph_id, unsigned int is_on, unsigned int *silent)
 {
-	/* disable console clock : forbiden */
-	if ((periph_id == AT91C_ID_USART3) && (is_on == 0)) {
-		/* keep it silent */
-		*silent = 1;
-		return 1;
-	} else {
+	if (is_on || (periph_id >= AT91C_ID_COUNTS))
 		return 0;
-	}
+
+	if (!((peri_clk_locked_map[periph_id / 32] >> (periph_id % 32)) & 1))
+		return 0;
+
+	/* keep it silent */
+	*silent = 1;
+	return 1;
 }
 #endif /* CONFIG_SAMA5D4 */
 
 #ifdef CONFIG_SAMA7G5
 
-void matrix_configure_default_qos()
+#define MATRIX_QOS_SLAVES	8
+
+static void matrix_set_master_qos(unsigned int amp_val, unsigned int bmp_val)
 {
 	unsigned int amp_mask = MATRIX_PRAS_M0PR_MASK | MATRIX_PRAS_M1PR_MASK |
 		MATRIX_PRAS_M2PR_MASK | MATRIX_PRAS_M3PR_MASK |
@@ -579,6 +627,32 @@ void matrix_configure_default_qos()
 		MATRIX_PRAS_M10PR_MASK | MATRIX_PRAS_M11PR_MASK |
 		MATRIX_PRAS_M12PR_MASK | MATRIX_PRAS_M13PR_MASK |
 		MATRIX_PRAS_M14PR_MASK;
+	unsigned int pras, prbs;
+	unsigned int i;
+
+	/* clear the Master Priority fields */
+	for (i = 0; i < MATRIX_QOS_SLAVES; i++) {
+		pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS0 + i * 8);
+		matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS0 + i * 8,
+			     pras & ~amp_mask);
+		prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS0 + i * 8);
+		matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS0 + i * 8,
+			     prbs & ~bmp_mask);
+	}
+
+	/* set the Master Priority fields */
+	for (i = 0; i < MATRIX_QOS_SLAVES; i++) {
+		pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS0 + i * 8);
+		matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS0 + i * 8,
+			     pras | amp_val);
+		prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS0 + i * 8);
+		matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS0 + i * 8,
+			     prbs | bmp_val);
+	}
+}
+
+void matrix_configure_default_qos()
+{
 	unsigned int amp_val = MATRIX_PRAS_M0PR(RESET_DEFAULT_MASTER_SQOS0) |
 				MATRIX_PRAS_M1PR(RESET_DEFAULT_MASTER_SQOS1) |
 				MATRIX_PRAS_M2PR(RESET_DEFAULT_MASTER_SQOS2) |
@@ -595,77 +669,14 @@ void matrix_configure_default_qos()
 				MATRIX_PRBS_M13PR(RESET_DEFAULT_MASTER_SQOS13) |
 				MATRIX_PRBS_M14PR(RESET_DEFAULT_MASTER_SQOS14) |
 				MATRIX_PRBS_M15PR(RESET_DEFAULT_MASTER_SQOS15);
-	unsigned int pras, prbs;
 
-	/* clear the Master Priority fields */
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS0);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS0, pras & ~amp_mask);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS1);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS1, pras & ~amp_mask);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS2);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS2, pras & ~amp_mask);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS3);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS3, pras & ~amp_mask);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS4);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS4, pras & ~amp_mask);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS5);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS5, pras & ~amp_mask);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS6);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS6, pras & ~amp_mask);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS7);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS7, pras & ~amp_mask);
-
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS0);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS0, prbs & ~bmp_mask);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS1);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS1, prbs & ~bmp_mask);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS2);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS2, prbs & ~bmp_mask);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS3);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS3, prbs & ~bmp_mask);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS4);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS4, prbs & ~bmp_mask);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS5);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS5, prbs & ~bmp_mask);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS6);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS6, prbs & ~bmp_mask);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS7);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS7, prbs & ~bmp_mask);
+	matrix_set_master_qos(amp_val, bmp_val);
+}
 
-	/* set the Master Priority fields */
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS0);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS0, pras | amp_val);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS1);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS1, pras | amp_val);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS2);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS2, pras | amp_val);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS3);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS3, pras | amp_val);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS4);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS4, pras | amp_val);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS5);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS5, pras | amp_val);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS6);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS6, pras | amp_val);
-	pras = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRAS7);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRAS7, pras | amp_val);
-
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS0);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS0, prbs | bmp_val);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS1);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS1, prbs | bmp_val);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS2);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS2, prbs | bmp_val);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS3);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS3, prbs | bmp_val);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS4);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS4, prbs | bmp_val);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS5);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS5, prbs | bmp_val);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS6);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS6, prbs | bmp_val);
-	prbs = matrix_read(AT91C_BASE_MATRIX, MATRIX_PRBS7);
-	matrix_write(AT91C_BASE_MATRIX, MATRIX_PRBS7, prbs | bmp_val);
+/* Clear all the master priorities, as the matrix comes out of reset */
+void matrix_clear_master_qos(void)
+{
+	matrix_set_master_qos(0, 0);
 }
 
 #endif /* CONFIG_SAMA7G5 */
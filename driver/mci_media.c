@@ -944,6 +944,81 @@ static int sdcard_identification(struct sd_card *sdcard)
 	return 0;
 }
 
+#ifdef CONFIG_SDCARD_REUSE_ROM_STATE
+/* CURRENT_STATE field of the card status */
+#define CARD_STATUS_STATE(x)		(((x) >> 9) & 0x0f)
+#define CARD_STATUS_STATE_STBY		3
+#define CARD_STATUS_STATE_TRAN		4
+
+/*
+ * Probe for an eMMC device the ROM code left identified, and rebuild
+ * what sdcard_identification() would have learned from it without
+ * going back through the idle state.
+ */
+static int mmc_reuse_rom_state(struct sd_card *sdcard)
+{
+	struct sd_host *host = sdcard->host;
+	struct sd_command *command = sdcard->command;
+	unsigned int state;
+	unsigned int c_size;
+	int ret;
+
+	sdcard->reg->rca = CONFIG_SDCARD_ROM_RCA;
+
+	command->cmd = SD_CMD_SEND_STATUS;
+	command->resp_type = SD_RESP_TYPE_R1;
+	command->argu = sdcard->reg->rca << 16;
+
+	ret = host->ops->send_command(command, 0);
+	if (ret)
+		return ret;
+
+	state = CARD_STATUS_STATE(command->resp[0]);
+	if (state == CARD_STATUS_STATE_TRAN) {
+		/*
+		 * The host has just been reset to a 1 bit bus, bring the
+		 * device back to it before any data transfer, then
+		 * deselect it so that its CSD can be read.
+		 */
+		ret = mmc_cmd_switch_fun(sdcard,
+				MMC_EXT_CSD_ACCESS_WRITE_BYTE,
+				EXT_CSD_BYTE_BUS_WIDTH,
+				MMC_BUS_WIDTH_1);
+		if (ret)
+			return ret;
+
+		command->cmd = SD_CMD_SELECT_CARD;
+		command->resp_type = SD_RESP_TYPE_NO_RESP;
+		command->argu = 0;
+
+		ret = host->ops->send_command(command, 0);
+		if (ret)
+			return ret;
+	} else if (state != CARD_STATUS_STATE_STBY) {
+		return ERROR_UNUSABLE_CARD;
+	}
+
+	ret = sd_cmd_send_csd(sdcard);
+	if (ret)
+		return ret;
+
+	/* SD cards use CSD structure 0 or 1 */
+	if ((sdcard->reg->csd[0] >> 30) < 2)
+		return ERROR_UNUSABLE_CARD;
+
+	/* Devices above 2GB are sector addressed and report C_SIZE 0xfff */
+	c_size = ((sdcard->reg->csd[1] & 0x3ff) << 2)
+			| (sdcard->reg->csd[2] >> 30);
+	sdcard->highcapacity_card = (c_size == 0xfff) ? 1 : 0;
+
+	sdcard->card_type = CARD_TYPE_MMC;
+	sdcard->read_bl_len = DEFAULT_SD_BLOCK_LEN;
+
+	dbg_info("MMC: reusing the device state left by the ROM code\n");
+	return 0;
+}
+#endif
+
 static int sd_initialization(struct sd_card *sdcard)
 {
 	struct sd_host *host = sdcard->host;
@@ -1134,8 +1209,15 @@ int sdcard_initialize(void)
 			return ret;
 	}
 
+#ifdef CONFIG_SDCARD_REUSE_ROM_STATE
+	ret = mmc_reuse_rom_state(sdcard);
+	if (ret)
+		/* Card Indentification Mode */
+		ret = sdcard_identification(sdcard);
+#else
 	/* Card Indentification Mode */
 	ret = sdcard_identification(sdcard);
+#endif
 	if (ret)
 		return ret;
 
@@ -1248,6 +1330,7 @@ unsigned int sdcard_block_read(unsigned int start,
 				void *buf)
 {
 	struct sd_card *sdcard = &atmel_sdcard;
+	unsigned int max_blocks = sdcard->host->caps_max_blocks;
 	unsigned int blocks_todo = block_count;
 	unsigned int blocks;
 	unsigned int block_len = sdcard->read_bl_len;
@@ -1266,9 +1349,12 @@ unsigned int sdcard_block_read(unsigned int start,
 			return ret;
 	}
 
+	if (!max_blocks)
+		max_blocks = SUPPORT_MAX_BLOCKS;
+
 	for (blocks_todo = block_count; blocks_todo > 0; ) {
-		blocks = (blocks_todo > SUPPORT_MAX_BLOCKS) ?
-					SUPPORT_MAX_BLOCKS : blocks_todo;
+		blocks = (blocks_todo > max_blocks) ?
+					max_blocks : blocks_todo;
 
 		if (blocks > 1) {
 			blocks_read = sd_cmd_read_multiple_block(sdcard,
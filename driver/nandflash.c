@@ -7,7 +7,7 @@
 #include "board.h"
 #include "arch/at91_pio.h"
 
-#if defined(CONFIG_SAMA5D2) || defined(CONFIG_SAMA5D3) ||\
+#if defined(CONFIG_SAMA5D2) || defined(CONFIG_SAMA5D3X) ||\
     defined(CONFIG_SAMA5D4) || defined(CONFIG_SAMA7G5)
 #include "arch/sama5_smc.h"
 #else
@@ -22,7 +22,10 @@
 #include "hamming.h"
 #include "timer.h"
 #include "fdt.h"
+#include "secure.h"
+#include "ubi.h"
 #include "div.h"
+#include "string.h"
 #ifdef CONFIG_NAND_DMA_SUPPORT
 #include "xdmac.h"
 #endif
@@ -137,7 +140,7 @@ static const struct nand_timing nand_onfi_timings[] = {
 };
 
 #define DIV_ROUND_UP(x, y)	div(((x) + (y) - 1),(y))
-#if defined(CONFIG_SAMA5D2) || defined(CONFIG_SAMA5D3) ||\
+#if defined(CONFIG_SAMA5D2) || defined(CONFIG_SAMA5D3X) ||\
     defined(CONFIG_SAMA5D4) || defined(CONFIG_SAMA7G5)
 static unsigned int smc_timing_encode_ncycles(unsigned int ncycles)
 {
@@ -220,7 +223,7 @@ void nandflash_smc_conf(unsigned int mode, unsigned int cs)
 	nrd_cycle = max(ncycles, nrd_cycle);
 
 	/* NCS_RD_PULSE = NRD_CYCLE */
-#if defined(CONFIG_SAMA5D2) || defined(CONFIG_SAMA5D3) ||\
+#if defined(CONFIG_SAMA5D2) || defined(CONFIG_SAMA5D3X) ||\
     defined(CONFIG_SAMA5D4) || defined(CONFIG_SAMA7G5)
 	writel(AT91C_SMC_SETUP_NWE(nwe_setup), ATMEL_BASE_SMC + SMC_SETUP(cs));
 	writel(AT91C_SMC_PULSE_NWE(nwe_pulse) |
@@ -960,37 +963,59 @@ static int nand_read_status(void)
 }
 
 #ifdef CONFIG_NAND_DMA_SUPPORT
-static int nand_read_with_dma(unsigned char *buffer,
+static int nand_dma_start(struct xdmac_hwcfg *hwcfg,
+			void *src,
+			unsigned int data_width,
+			unsigned char *buffer,
 			unsigned int len)
 {
-	struct xdmac_hwcfg hwcfg;
 	struct xdmac_cfg cfg;
 	struct xdmac_transfer_cfg transfer_cfg;
 	int ret;
 
-	hwcfg.pid = 0xFF;
-	hwcfg.cid = 0;
-	hwcfg.src_is_periph = 0;
-	hwcfg.dst_is_periph = 0;
-	cfg.data_width = DMA_DATA_WIDTH_BYTE;
+	hwcfg->pid = 0xFF;
+	hwcfg->cid = 0;
+	hwcfg->src_is_periph = 0;
+	hwcfg->dst_is_periph = 0;
+	cfg.data_width = data_width;
 	cfg.chunk_size = DMA_CHUNK_SIZE_1;
 	cfg.burst_size = DMA_MEM_BURST_16;
 	cfg.incr_saddr = 1;
 	cfg.incr_daddr = 1;
-	ret = xdmac_configure_transfer(&hwcfg, &cfg);
+	ret = xdmac_configure_transfer(hwcfg, &cfg);
 	if (ret)
-		goto dma_stop;
-	transfer_cfg.saddr = (void *)CONFIG_SYS_NAND_BASE;
+		return ret;
+	transfer_cfg.saddr = src;
 	transfer_cfg.daddr = (void *)buffer;
-	transfer_cfg.len = len;
-	ret = xdmac_transfer_start(&hwcfg, &transfer_cfg);
-	if (ret)
-		goto dma_stop;
-	ret = xdmac_transfer_wait_for_completion(&hwcfg);
-dma_stop:
-	xdmac_transfer_stop(&hwcfg);
+	transfer_cfg.len = len >> data_width;
+	return xdmac_transfer_start(hwcfg, &transfer_cfg);
+}
+
+static int nand_dma_finish(struct xdmac_hwcfg *hwcfg)
+{
+	int ret;
+
+	ret = xdmac_transfer_wait_for_completion(hwcfg);
+	xdmac_transfer_stop(hwcfg);
+
 	return ret;
 }
+
+static int nand_read_with_dma(unsigned char *buffer,
+			unsigned int len)
+{
+	struct xdmac_hwcfg hwcfg;
+	int ret;
+
+	ret = nand_dma_start(&hwcfg, (void *)CONFIG_SYS_NAND_BASE,
+			     DMA_DATA_WIDTH_BYTE, buffer, len);
+	if (ret) {
+		xdmac_transfer_stop(&hwcfg);
+		return ret;
+	}
+
+	return nand_dma_finish(&hwcfg);
+}
 #endif
 
 #ifdef CONFIG_NANDFLASH_SMALL_BLOCKS
@@ -1143,7 +1168,287 @@ static int nand_read_sector(struct nand_info *nand,
 }
 #endif /* #ifdef CONFIG_NANDFLASH_SMALL_BLOCKS */
 
-static int nand_check_badblock(struct nand_info *nand,
+#if defined(CONFIG_USE_PMECC) && !defined(CONFIG_NANDFLASH_SMALL_BLOCKS) \
+    && !defined(CONFIG_NAND_NFC)
+/*
+ * Read consecutive pages of a block, correcting each page while the
+ * next one is fetched: its PMECC state is latched, the next read is
+ * issued, and the correction runs during tR, or during the transfer
+ * when it is done by DMA.
+ *
+ * The next page lands over the spare area of the pending one, so bit
+ * errors in the ECC bytes are left uncorrected; nothing reads them.
+ */
+static int nand_read_pages_pmecc(struct nand_info *nand,
+				unsigned int row_address,
+				unsigned int numpages,
+				unsigned char *buffer)
+{
+	static struct pmecc_page pending;
+	unsigned char *pending_buf = NULL;
+#ifdef CONFIG_NAND_DMA_SUPPORT
+	struct xdmac_hwcfg hwcfg;
+#else
+	unsigned char *pbuf;
+	unsigned int i;
+#endif
+	unsigned int page;
+	int ret = 0;
+
+	for (page = 0; page < numpages; page++) {
+		pmecc_enable();
+
+		nand_cs_enable();
+
+		nand->command(CMD_READ_1);
+
+		write_column_address(nand, 0);
+		write_row_address(nand, row_address + page);
+
+		nand->command(CMD_READ_2);
+
+#ifndef CONFIG_NAND_DMA_SUPPORT
+		if (pending_buf && pmecc_correct(nand, pending_buf, &pending))
+			return -1;
+#endif
+
+		if (nand_read_status())
+			return -1;
+
+		nand->command(CMD_READ_1);
+
+		pmecc_start_data_phase();
+
+#ifdef CONFIG_NAND_DMA_SUPPORT
+		ret = nand_dma_start(&hwcfg, (void *)CONFIG_SYS_NAND_BASE,
+				     DMA_DATA_WIDTH_BYTE, buffer,
+				     nand->sectorsize);
+		if (ret) {
+			xdmac_transfer_stop(&hwcfg);
+			return -1;
+		}
+
+		if (pending_buf)
+			ret = pmecc_correct(nand, pending_buf, &pending);
+
+		if (nand_dma_finish(&hwcfg) || ret)
+			return -1;
+#else
+		pbuf = buffer;
+		for (i = 0; i < nand->sectorsize; i++)
+			*pbuf++ = read_byte();
+#endif
+
+		nand_cs_disable();
+
+		pmecc_latch(nand, buffer, &pending);
+		pending.correct_oob = 0;
+		pending_buf = buffer;
+
+		buffer += nand->pagesize;
+	}
+
+	if (pending_buf)
+		ret = pmecc_correct(nand, pending_buf, &pending);
+
+	return ret;
+}
+#endif
+
+#ifdef CONFIG_NAND_NFC
+/* The NAND flash is on the chip select 3 */
+#define NFC_NAND_CS	3
+
+static inline void nfc_writel(unsigned int value, unsigned int reg)
+{
+	writel(value, AT91C_BASE_SMC + reg);
+}
+
+static inline unsigned int nfc_readl(unsigned int reg)
+{
+	return readl(AT91C_BASE_SMC + reg);
+}
+
+static void nfc_enable(struct nand_info *nand)
+{
+	unsigned int pagesize = 0;
+
+	while ((512 << pagesize) < nand->pagesize)
+		pagesize++;
+
+	/* the longest data timeout, tR is waited for by the NFC */
+	nfc_writel(AT91C_NFC_CFG_PAGESIZE(pagesize)
+		   | AT91C_NFC_CFG_RSPARE
+		   | AT91C_NFC_CFG_SPARESIZE((nand->oobsize / 4) - 1)
+		   | AT91C_NFC_CFG_DTOCYC(0xf)
+		   | AT91C_NFC_CFG_DTOMUL(0x7),
+		   HSMC_NFC_CFG);
+	nfc_writel(0, HSMC_NFC_BANK);
+	nfc_writel(AT91C_NFC_CTRL_NFCEN, HSMC_NFC_CTRL);
+}
+
+static void nfc_disable(void)
+{
+	nfc_writel(AT91C_NFC_CTRL_NFCDIS, HSMC_NFC_CTRL);
+}
+
+/*
+ * Issue the whole page read, command, address and data phases, the
+ * page and its spare area landing in the NFC SRAM.
+ */
+static int nfc_read_page_start(struct nand_info *nand,
+			       unsigned int row_address)
+{
+	unsigned char cycles[8];
+	unsigned int page_size = nand->pagesize;
+	unsigned int num_pages = nand->pages_device;
+	unsigned int ncycles = 0;
+	unsigned int first = 0;
+	unsigned int data = 0;
+	unsigned int i;
+
+	/* column 0, then the row, as write_column/row_address() */
+	while (page_size > 2) {
+		cycles[ncycles++] = 0;
+		page_size >>= 8;
+	}
+	while (num_pages) {
+		cycles[ncycles++] = row_address & 0xff;
+		num_pages >>= 8;
+		row_address >>= 8;
+	}
+
+	if (ncycles > 5)
+		return -1;
+
+	/* the fifth address cycle goes first, through NFC_ADDR */
+	if (ncycles == 5)
+		nfc_writel(cycles[first++], HSMC_NFC_ADDR);
+
+	for (i = first; i < ncycles; i++)
+		data |= cycles[i] << ((i - first) * 8);
+
+	/* clear the status */
+	nfc_readl(HSMC_NFC_SR);
+
+	writel(data, AT91C_BASE_NFC_CMD
+		     + (AT91C_NFC_CMD1(CMD_READ_1)
+			| AT91C_NFC_CMD2(CMD_READ_2)
+			| AT91C_NFC_VCMD2
+			| AT91C_NFC_ACYCLE(ncycles)
+			| AT91C_NFC_CSID(NFC_NAND_CS)
+			| AT91C_NFC_DATAEN));
+
+	return 0;
+}
+
+static int nfc_read_page_wait(void)
+{
+	unsigned int timeout = 1000000;
+	unsigned int done = AT91C_NFC_SR_CMDDONE | AT91C_NFC_SR_XFRDONE;
+	unsigned int status = 0;
+
+	/* the status flags are cleared on read */
+	do {
+		status |= nfc_readl(HSMC_NFC_SR);
+		if (status & AT91C_NFC_SR_ERRORS) {
+			dbg_info("NAND: NFC error, status: %x\n", status);
+			return -1;
+		}
+	} while (((status & done) != done) && --timeout);
+
+	if (!timeout) {
+		dbg_info("NAND: NFC timeout\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int nfc_sram_copy(unsigned char *buffer, unsigned int len)
+{
+#ifdef CONFIG_NAND_DMA_SUPPORT
+	struct xdmac_hwcfg hwcfg;
+	int ret;
+
+	ret = nand_dma_start(&hwcfg, (void *)AT91C_BASE_NFC_SRAM,
+			     DMA_DATA_WIDTH_WORD, buffer, len);
+	if (ret) {
+		xdmac_transfer_stop(&hwcfg);
+		return ret;
+	}
+
+	return nand_dma_finish(&hwcfg);
+#else
+	memcpy(buffer, (void *)AT91C_BASE_NFC_SRAM, len);
+
+	return 0;
+#endif
+}
+
+/*
+ * Same as nand_read_pages_pmecc(), the NFC doing the command, address
+ * and data phases on its own: the PMECC correction of a page runs while
+ * the next one is read into the NFC SRAM, and the CPU only waits for
+ * the copy out of it.
+ */
+static int nand_read_pages_nfc(struct nand_info *nand,
+			       unsigned int row_address,
+			       unsigned int numpages,
+			       unsigned char *buffer)
+{
+	static struct pmecc_page pending;
+	unsigned char *pending_buf = NULL;
+	unsigned int page;
+	int ret = 0;
+
+	nfc_enable(nand);
+
+	for (page = 0; page < numpages; page++) {
+		pmecc_enable();
+		pmecc_start_data_phase();
+
+		nand_cs_enable();
+
+		ret = nfc_read_page_start(nand, row_address + page);
+		if (ret)
+			break;
+
+		if (pending_buf)
+			ret = pmecc_correct(nand, pending_buf, &pending);
+
+		if (nfc_read_page_wait() || ret) {
+			ret = -1;
+			break;
+		}
+
+		nand_cs_disable();
+
+		ret = nfc_sram_copy(buffer, nand->sectorsize);
+		if (ret)
+			break;
+
+		pmecc_latch(nand, buffer, &pending);
+		pending.correct_oob = 0;
+		pending_buf = buffer;
+
+		buffer += nand->pagesize;
+	}
+
+	nand_cs_disable();
+	nfc_disable();
+
+	if (ret)
+		return -1;
+
+	if (pending_buf)
+		ret = pmecc_correct(nand, pending_buf, &pending);
+
+	return ret;
+}
+#endif
+
+int nand_check_badblock(struct nand_info *nand,
 				unsigned int block,
 				unsigned char *buffer)
 {
@@ -1266,19 +1571,60 @@ static int nandflash_recovery(struct nand_info *nand)
 }
 #endif /* #ifdef CONFIG_NANDFLASH_RECOVERY */
 
+/* Read pages of a block, the page data landing back to back in buffer */
+int nand_read_block_pages(struct nand_info *nand,
+			  unsigned int block,
+			  unsigned int start_page,
+			  unsigned int numpages,
+			  unsigned char *buffer)
+{
+	unsigned int page;
+	int ret;
+
+#if defined(CONFIG_USE_PMECC) && !defined(CONFIG_NANDFLASH_SMALL_BLOCKS)
+	if (!nand->buswidth) {
+#ifdef CONFIG_NAND_NFC
+		return nand_read_pages_nfc(nand,
+				block * nand->pages_block + start_page,
+				numpages, buffer);
+#else
+		return nand_read_pages_pmecc(nand,
+				block * nand->pages_block + start_page,
+				numpages, buffer);
+#endif
+	}
+#endif
+
+	for (page = start_page; page < start_page + numpages; page++) {
+		ret = nand_read_page(nand, block, page, ZONE_DATA, buffer);
+		if (ret)
+			return -1;
+
+		buffer += nand->pagesize;
+	}
+
+	return 0;
+}
+
+#ifndef CONFIG_NANDFLASH_UBI
+/*
+ * Copy length bytes from offset to dest. The first skip pages are
+ * already at dest, e.g. the header page read by update_image_length(),
+ * and are not read again.
+ */
 static int nand_loadimage(struct nand_info *nand,
 				unsigned int offset,
 				unsigned int length,
-				unsigned char *dest)
+				unsigned char *dest,
+				unsigned int skip)
 {
 	unsigned char *buffer = dest;
 	unsigned int readsize;
 	unsigned int block = 0;
-	unsigned int page;
 	unsigned int start_page = 0;
-	unsigned int end_page;
 	unsigned int numpages = 0;
 	unsigned int offsetpage = 0;
+	unsigned int skipped;
 	unsigned int block_remaining = nand->blocksize
 				       - mod(offset, nand->blocksize);
 	int ret;
@@ -1298,7 +1644,8 @@ static int nand_loadimage(struct nand_info *nand,
 		if (offsetpage)
 			numpages++;
 
-		end_page = start_page + numpages;
+		skipped = (skip < numpages) ? skip : numpages;
+		skip -= skipped;
 
 		/* check the bad block */
 		while (1) {
@@ -1311,16 +1658,17 @@ static int nand_loadimage(struct nand_info *nand,
 				break;
 		}
 
-		/* read pages of a block */
-		for (page = start_page; page < end_page; page++) {
+		start_page += skipped;
+		numpages -= skipped;
+		buffer += skipped * nand->pagesize;
 
-			ret = nand_read_page(nand, block, page,
-						ZONE_DATA, buffer);
-			if (ret)
-				return -1;
-			else
-				buffer += nand->pagesize;
-		}
+		ret = nand_read_block_pages(nand, block, start_page,
+					    numpages, buffer);
+		if (ret)
+			return -1;
+
+		uimage_crc_update(buffer, numpages * nand->pagesize);
+		buffer += numpages * nand->pagesize;
 		length -= readsize;
 
 		block++;
@@ -1340,7 +1688,7 @@ static int update_image_length(struct nand_info *nand,
 	unsigned int length = nand->pagesize;
 	int ret;
 
-	ret = nand_loadimage(nand, offset, length, dest);
+	ret = nand_loadimage(nand, offset, length, dest, 0);
 	if (ret)
 		return -1;
 
@@ -1356,11 +1704,11 @@ static int update_image_length(struct nand_info *nand,
 	return -1;
 }
 #endif
+#endif	/* #ifndef CONFIG_NANDFLASH_UBI */
 
 int load_nandflash(struct image_info *image)
 {
 	struct nand_info nand;
-	int ret;
 
 	nandflash_hw_init();
 
@@ -1381,19 +1729,42 @@ int load_nandflash(struct image_info *image)
 	dbg_info("NAND: Using Software ECC\n");
 #endif
 
-#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	uimage_crc_start(image->dest);
+
+#ifdef CONFIG_NANDFLASH_UBI
+	return ubi_load_image(&nand, image);
+#else
+	/* pages already in place from the header probe */
+	unsigned int skip = 0;
+	int ret;
+
+#if defined(CONFIG_SECURE)
+	int length;
+
+	ret = nand_loadimage(&nand, image->offset, nand.pagesize,
+			     image->dest, 0);
+	length = ret ? -1 : secure_image_length(image->dest,
+						secure_image_room(image));
+	if (length == -1)
+		return -1;
+
+	image->length = length;
+	skip = 1;
+#elif defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
 	int length = update_image_length(&nand,
 				image->offset, image->dest, KERNEL_IMAGE);
 	if (length == -1)
 		return -1;
 
 	image->length = length;
+	skip = 1;
 #endif
 
 	dbg_info("NAND: Image: Copy %x bytes from %x to %x\n",
 			image->length, image->offset, image->dest);
 
-	ret = nand_loadimage(&nand, image->offset, image->length, image->dest);
+	ret = nand_loadimage(&nand, image->offset, image->length, image->dest,
+			     skip);
 	if (ret)
 		return ret;
 
@@ -1409,10 +1780,11 @@ int load_nandflash(struct image_info *image)
 		image->of_length, image->of_offset, image->of_dest);
 
 	ret = nand_loadimage(&nand, image->of_offset,
-				image->of_length, image->of_dest);
+				image->of_length, image->of_dest, 1);
 	if (ret)
 		return ret;
 #endif
 
 	return 0;
+#endif	/* #ifdef CONFIG_NANDFLASH_UBI */
  }
@@ -68,6 +68,16 @@ static u64 pit64b_read_value(void)
 	return (((u64)high << 32) | low);
 }
 
+unsigned int timer_get_ticks(void)
+{
+	return (u32)pit64b_read_value();
+}
+
+unsigned int timer_get_rate(void)
+{
+	return clk_rate;
+}
+
 void udelay(unsigned int usec)
 {
 	u64 base = pit64b_read_value();
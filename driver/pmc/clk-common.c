@@ -34,6 +34,26 @@ void lowlevel_clock_init()
 	pmc_mck_cfg_set(0, AT91C_PMC_CSS_SLOW_CLK, AT91C_PMC_CSS);
 #endif
 
+#if defined(CONFIG_SAMA5D3X) || defined(CONFIG_SAMA5D4) || \
+	defined(CONFIG_SAMA5D2) || defined(CONFIG_SAM9X60) || \
+	defined(CONFIG_SAM9X7) || defined(CONFIG_SAMA7G5)
+	/*
+	 * Enable the Main Crystal Oscillator
+	 * tST_max = 2ms
+	 * Startup Time: 32768 * 2ms / 8 = 8
+	 *
+	 * The main clock stays on the RC oscillator until MOSCSEL is set,
+	 * the crystal starts up while the steps below run.
+	 */
+	tmp = read_pmc(PMC_MOR);
+	tmp &= (~AT91C_CKGR_MOSCXTST);
+	tmp &= (~AT91C_CKGR_KEY);
+	tmp |= AT91C_CKGR_MOSCXTEN;
+	tmp |= AT91_CKGR_MOSCXTST_SET(8);
+	tmp |= AT91C_CKGR_PASSWD;
+	write_pmc(PMC_MOR, tmp);
+#endif
+
 #ifdef CONFIG_SAMA7G5
 	/*
 	 * SAMA7G5 comes with predefined clock scheme from Rom Code.
@@ -54,19 +74,7 @@ void lowlevel_clock_init()
 #if defined(CONFIG_SAMA5D3X) || defined(CONFIG_SAMA5D4) || \
 	defined(CONFIG_SAMA5D2) || defined(CONFIG_SAM9X60) || \
 	defined(CONFIG_SAM9X7) || defined(CONFIG_SAMA7G5)
-	/*
-	 * Enable the Main Crystal Oscillator
-	 * tST_max = 2ms
-	 * Startup Time: 32768 * 2ms / 8 = 8
-	 */
-	tmp = read_pmc(PMC_MOR);
-	tmp &= (~AT91C_CKGR_MOSCXTST);
-	tmp &= (~AT91C_CKGR_KEY);
-	tmp |= AT91C_CKGR_MOSCXTEN;
-	tmp |= AT91_CKGR_MOSCXTST_SET(8);
-	tmp |= AT91C_CKGR_PASSWD;
-	write_pmc(PMC_MOR, tmp);
-
+	/* The crystal was started above, wait for its start-up time */
 	while (!(read_pmc(PMC_SR) & AT91C_PMC_MOSCXTS))
 		;
 
@@ -109,19 +109,11 @@ int pmc_enable_generic_clock(unsigned int periph_id, unsigned int clk_source,
 	return 0;
 }
 
-unsigned int pmc_get_generic_clock(unsigned int periph_id)
+static unsigned int gck_source_rate(unsigned int clock_source)
 {
 	unsigned int tmp;
-	unsigned int clock_source, divider;
 	unsigned int freq = 0;
 
-	write_pmc(PMC_PCR, periph_id);
-	tmp = read_pmc(PMC_PCR);
-
-	divider = (tmp >> AT91C_PMC_GCKDIV_OFFSET) & AT91C_PMC_GCKDIV_MSK;
-	divider += 1;
-
-	clock_source = tmp & AT91C_PMC_GCKCSS;
 	switch (clock_source) {
 	case AT91C_PMC_GCKCSS_MAIN_CLK:
 #ifdef BOARD_MAINOSC
@@ -160,8 +152,32 @@ unsigned int pmc_get_generic_clock(unsigned int periph_id)
 		break;
 	}
 
-	freq = div(freq, divider);
-
 	return freq;
 }
 
+unsigned int pmc_get_generic_clock(unsigned int periph_id)
+{
+	unsigned int tmp;
+	unsigned int divider;
+
+	write_pmc(PMC_PCR, periph_id);
+	tmp = read_pmc(PMC_PCR);
+
+	divider = (tmp >> AT91C_PMC_GCKDIV_OFFSET) & AT91C_PMC_GCKDIV_MSK;
+	divider += 1;
+
+	return div(gck_source_rate(tmp & AT91C_PMC_GCKCSS), divider);
+}
+
+/*
+ * Rate of a GCK_CSS_* source before the generic clock divider, 0 when
+ * it is not known
+ */
+unsigned int pmc_get_generic_clock_source_rate(unsigned int clk_source)
+{
+	if (clk_source >= ARRAY_SIZE(css_idx_to_reg))
+		return 0;
+
+	return gck_source_rate(CSS_IDX_TO_REGVAL(clk_source));
+}
+
@@ -12,18 +12,21 @@
 
 static struct pmc_pll_cfg config[PLL_ID_MAX] = { 0 };
 
-void pmc_sam9x60_cfg_pll(unsigned int pll_id, struct pmc_pll_cfg *cfg)
+/*
+ * Program a PLL and let it start up, without waiting for its lock, so that
+ * several PLLs can lock at the same time: see pmc_sam9x60_wait_pll().
+ */
+int pmc_sam9x60_start_pll(unsigned int pll_id, struct pmc_pll_cfg *cfg)
 {
-
 	unsigned int reg;
 
 	if (pll_id < 0 || pll_id >= PLL_ID_MAX)
-		return;
+		return -1;
 
 #ifdef CONFIG_PMC_V2
 	if (pll_id == PLL_ID_UPLL) {
 		if (cfg->div != 1)
-			return;
+			return -1;
 	}
 #endif
 
@@ -70,11 +73,44 @@ void pmc_sam9x60_cfg_pll(unsigned int pll_id, struct pmc_pll_cfg *cfg)
 	reg |= AT91C_PLL_UPDT_UPDATE;
 	write_pmc(PMC_PLL_UPDT, reg);
 
-	while ((read_pmc(PMC_PLL_ISR0) & (AT91C_PLL_ISR0_LOCKA << pll_id))
-			!= (AT91C_PLL_ISR0_LOCKA << pll_id))
-		;
-
 	config[pll_id] = *(struct pmc_pll_cfg *) cfg;
+
+	return 0;
+}
+
+/*
+ * Wait for the lock of the PLLs in mask, one bit per PLL ID. When the
+ * timer runs, lock_ticks[pll_id] receives the time each of them took to
+ * lock from the call, otherwise lock_ticks is NULL.
+ */
+void pmc_sam9x60_wait_pll(unsigned int mask, unsigned int *lock_ticks)
+{
+	unsigned int lock = mask * AT91C_PLL_ISR0_LOCKA;
+	unsigned int pending = lock;
+	unsigned int start = 0, locked, pll_id;
+
+	if (lock_ticks)
+		start = timer_get_ticks();
+
+	while (pending) {
+		locked = read_pmc(PMC_PLL_ISR0) & pending;
+		if (!locked)
+			continue;
+
+		pending &= ~locked;
+		if (!lock_ticks)
+			continue;
+
+		for (pll_id = 0; pll_id < PLL_ID_MAX; pll_id++)
+			if (locked & (AT91C_PLL_ISR0_LOCKA << pll_id))
+				lock_ticks[pll_id] = timer_get_ticks() - start;
+	}
+}
+
+void pmc_sam9x60_cfg_pll(unsigned int pll_id, struct pmc_pll_cfg *cfg)
+{
+	if (!pmc_sam9x60_start_pll(pll_id, cfg))
+		pmc_sam9x60_wait_pll(1 << pll_id, NULL);
 }
 
 #ifdef CONFIG_PMC_V2
@@ -423,18 +423,14 @@ static int check_pmecc_ecc_data(struct nand_info *nand,
 /*
  * \brief Build the pseudo syndromes table
  * \param pPmeccDescriptor Pointer to a PMECC_paramDesc instance.
- * \param sector Targetted sector.
+ * \param pRemainer Remainders of the targetted sector.
  */
 
-static void GenSyn(unsigned long pPMECC,
-		struct _PMECC_paramDesc_struct *pPmeccDescriptor,
-		unsigned int sector)
+static void GenSyn(struct _PMECC_paramDesc_struct *pPmeccDescriptor,
+		short *pRemainer)
 {
-	short *pRemainer;
 	unsigned int index;
 
-	pRemainer = (short *) (pPMECC + PMECC_REM + (sector * 0x40));
-
 	for (index = 0; index < pPmeccDescriptor->tt; index++)
 		/* Fill odd syndromes */
 		pPmeccDescriptor->partialSyn[1 +  (2 * index)]
@@ -748,7 +744,7 @@ static unsigned int ErrorCorrection(unsigned long pPMERRLOC,
 				*errByte,
 				*errByte ^ (1 << bitPos));
 			*errByte ^= (1 << bitPos);
-		} else {
+		} else if (eccBaseAddress) {
 			/* error is located in oob area */
 			errByte = (unsigned char *)(eccBaseAddress
 					+ (bytePos - sectorSize));
@@ -776,12 +772,12 @@ static unsigned int ErrorCorrection(unsigned long pPMERRLOC,
  * \param ErrorNbr Number of error to correct
  * \return 0 if all errors have been corrected, 1 if too many errors detected
  */
-static unsigned int PMECC_CorrectionAlgo(unsigned long pPMECC,
-		unsigned long pPMERRLOC,
+static unsigned int PMECC_CorrectionAlgo(unsigned long pPMERRLOC,
 		struct _PMECC_paramDesc_struct *pPmeccDescriptor,
-		unsigned int pmeccStatus,
+		struct pmecc_page *page,
 		void *pageBuffer)
 {
+	unsigned int pmeccStatus = page->erris;
 	unsigned int sectorNumber = 0;
 	unsigned int sectorBaseAddress, eccBaseAddr;
 	volatile int errorNbr;
@@ -807,12 +803,15 @@ static unsigned int PMECC_CorrectionAlgo(unsigned long pPMECC,
 
 			sectorBaseAddress = (unsigned int)pageBuffer
 					+ (sectorNumber * sector_size);
-			eccBaseAddr = (unsigned int)pageBuffer
+			if (page->correct_oob)
+				eccBaseAddr = (unsigned int)pageBuffer
 					+ page_size_byte
 					+ pmecc_readl(PMECC_SADDR)
 					+ (sectorNumber * ecc_byte_per_sector);
+			else
+				eccBaseAddr = 0;
 
-			GenSyn(pPMECC, pPmeccDescriptor, sectorNumber);
+			GenSyn(pPmeccDescriptor, page->rem[sectorNumber]);
 
 			substitute(pPmeccDescriptor);
 
@@ -859,47 +858,87 @@ static void page_dump(unsigned char *buf, int page_size, int oob_size)
 	dbg_loud("\n");
 }
 
-int pmecc_process(struct nand_info *nand, unsigned char *buffer)
+/*
+ * pmecc_latch - save the PMECC state of the page just read
+ *
+ * Once saved, the PMECC may be reset for the next page and the
+ * correction of this one run later with pmecc_correct().
+ */
+int pmecc_latch(struct nand_info *nand, unsigned char *buffer,
+		struct pmecc_page *page)
 {
-	int ret = 0;
-	int result;
-	unsigned int erris;
+	unsigned int sector, index;
+	short *pRemainer;
 
 	/* waiting for PMECC ready */
 	while (pmecc_readl(PMECC_SR) & AT91C_PMECC_BUSY)
 		;
 
 	/* read corrupted bit status */
-	erris = pmecc_readl(PMECC_ISR);
-	if (erris) {
+	page->erris = pmecc_readl(PMECC_ISR);
+	page->correct_oob = 1;
+	if (!page->erris)
+		return 0;
+
 #ifdef CONFIG_SAMA5D3X
-		if (check_pmecc_ecc_data(nand, buffer) == -1)
-			return 0;
+	if (check_pmecc_ecc_data(nand, buffer) == -1) {
+		page->erris = 0;
+		return 0;
+	}
 #endif
-		/* erris means which sector has errors. for example:
-		 * if erris is 0x9 (0b1001)
-		 *                    ^  ^
-		 * the bit 1 indicate the position of error sectors.
-		 * If we have 4 sectors, then that means the first
-		 * and last sector has errors.
-		 */
-		dbg_loud("PMECC: sector bits = %d, bit 1 means corrupted sector, Now correcting...\n", erris);
-		result = PMECC_CorrectionAlgo(AT91C_BASE_PMECC,
-					AT91C_BASE_PMERRLOC,
-					&PMECC_paramDesc,
-					erris,
-					buffer);
-
-		if (result != 0) {
-			dbg_info("PMECC: failed to " \
-					"correct corrupted bits!\n");
-			ret =  -1;
-
-			/* dump the whole page for test */
-			page_dump(buffer, nand->pagesize, nand->oobsize);
-		}
+
+	for (sector = 0; sector < PMECC_MAX_SECTORS; sector++) {
+		if (!(page->erris & (1 << sector)))
+			continue;
+
+		pRemainer = (short *)(AT91C_BASE_PMECC + PMECC_REM
+				      + (sector * 0x40));
+		for (index = 0; index < PMECC_paramDesc.tt; index++)
+			page->rem[sector][index] = pRemainer[index];
 	}
 
-	return ret;
+	return 0;
 }
 
+int pmecc_correct(struct nand_info *nand, unsigned char *buffer,
+		  struct pmecc_page *page)
+{
+	int result;
+
+	if (!page->erris)
+		return 0;
+
+	/* erris means which sector has errors. for example:
+	 * if erris is 0x9 (0b1001)
+	 *                    ^  ^
+	 * the bit 1 indicate the position of error sectors.
+	 * If we have 4 sectors, then that means the first
+	 * and last sector has errors.
+	 */
+	dbg_loud("PMECC: sector bits = %d, bit 1 means corrupted sector, Now correcting...\n", page->erris);
+	result = PMECC_CorrectionAlgo(AT91C_BASE_PMERRLOC,
+				&PMECC_paramDesc,
+				page,
+				buffer);
+
+	if (result != 0) {
+		dbg_info("PMECC: failed to " \
+				"correct corrupted bits!\n");
+
+		/* dump the whole page for test */
+		page_dump(buffer, nand->pagesize, nand->oobsize);
+
+		return -1;
+	}
+
+	return 0;
+}
+
+int pmecc_process(struct nand_info *nand, unsigned char *buffer)
+{
+	static struct pmecc_page page;
+
+	pmecc_latch(nand, buffer, &page);
+
+	return pmecc_correct(nand, buffer, &page);
+}
@@ -13,28 +13,153 @@
 
 #include "debug.h"
 
-#define CHUNK_SIZE	0x40000
+/*
+ * All the files needed for a load are resolved by a single scan of the
+ * root directory, the loaders then open them without searching. The
+ * names are kept with the results: a load asking for a name not in
+ * there scans again for its own set.
+ */
+static FLOOKUP	lookup[_MAX_LOOKUP];
+static char	lookup_name[_MAX_LOOKUP][FILENAME_BUF_LEN];
+static UINT	lookup_count;
+
+static bool sdcard_lookup_cached(const char *name)
+{
+	UINT	i;
+
+	for (i = 0; i < lookup_count; i++)
+		if (!strcmp(lookup[i].name, name))
+			return true;
+
+	return false;
+}
+
+static void sdcard_lookup_add(const char **names, UINT *count,
+			      const char *name)
+{
+	/* Longer names are left to f_open() */
+	if (name && *name && (strlen(name) < FILENAME_BUF_LEN)
+	    && (*count < _MAX_LOOKUP))
+		names[(*count)++] = name;
+}
+
+#ifdef CONFIG_OF_LIBFDT
+/*
+ * The dt blob comes from the card unless of_filename is unset, which
+ * leaves of_dest to bound the kernel only.
+ */
+static int sdcard_has_dt(struct image_info *image)
+{
+	return image->of_dest && image->of_filename;
+}
+#endif
+
+static void sdcard_lookup(struct image_info *image)
+{
+	const char	*names[_MAX_LOOKUP];
+	UINT	count = 0;
+	UINT	i;
+	FRESULT	fret;
+
+	sdcard_lookup_add(names, &count, image->filename);
+#ifdef CONFIG_OF_LIBFDT
+	if (sdcard_has_dt(image))
+		sdcard_lookup_add(names, &count, image->of_filename);
+#endif
+#ifdef CONFIG_OVERRIDE_CMDLINE_FROM_EXT_FILE
+	if (image->cmdline_args)
+		sdcard_lookup_add(names, &count, image->cmdline_file);
+#endif
+#ifdef CONFIG_LOAD_OPTEE
+	sdcard_lookup_add(names, &count, CONFIG_OPTEE_IMAGE_NAME);
+#endif
+
+	for (i = 0; i < count; i++)
+		if (!sdcard_lookup_cached(names[i]))
+			break;
+	if (i == count)
+		return;
+
+	for (i = 0; i < count; i++) {
+		strcpy(lookup_name[i], names[i]);
+		lookup[i].name = lookup_name[i];
+	}
+	lookup_count = count;
+
+	fret = f_lookup(lookup, lookup_count);
+	if (fret != FR_OK) {
+		dbg_info("*** FATFS: f_lookup: error %d\n", fret);
+		lookup_count = 0;
+	}
+}
+
+static FRESULT sdcard_open(FIL *file, char *filename)
+{
+	UINT	i;
+
+	for (i = 0; i < lookup_count; i++) {
+		if (strcmp(lookup[i].name, filename))
+			continue;
+
+		/* Names in a sub-directory were not resolved by the scan */
+		if (lookup[i].res == FR_NO_PATH)
+			break;
+
+		return f_open_lookup(file, &lookup[i]);
+	}
+
+	return f_open(file, filename, FA_OPEN_EXISTING | FA_READ);
+}
 
-static int sdcard_loadimage(char *filename, BYTE *dest)
+/* Called by f_stream() for each piece of the file once it is in memory */
+static UINT sdcard_consume(const BYTE *buff, UINT len, void *arg)
+{
+	uimage_crc_update((unsigned char *)buff, len);
+
+	return len;
+}
+
+/*
+ * Room available at dest: CONFIG_SDCARD_MAX_IMAGE_SIZE, less if the other
+ * image of the boot is loaded above dest within that distance.
+ */
+static UINT sdcard_window(struct image_info *image, unsigned char *dest)
+{
+	UINT max = CONFIG_SDCARD_MAX_IMAGE_SIZE;
+#ifdef CONFIG_OF_LIBFDT
+	unsigned char *other;
+
+	if (image->of_dest) {
+		other = (dest == image->of_dest) ? image->dest : image->of_dest;
+		if ((other > dest) && ((UINT)(other - dest) < max))
+			max = other - dest;
+	}
+#endif
+
+	return max;
+}
+
+static int sdcard_loadimage(char *filename, BYTE *dest, UINT max)
 {
 	FIL 	file;
-	UINT	byte_to_read = CHUNK_SIZE;
 	UINT	byte_read;
 	FRESULT	fret;
 	int	ret;
 
-	fret = f_open(&file, filename, FA_OPEN_EXISTING | FA_READ);
+	fret = sdcard_open(&file, filename);
 	if (fret != FR_OK) {
 		dbg_info("*** FATFS: f_open, filename: [%s]: error\n", filename);
 		ret = -1;
 		goto open_fail;
 	}
 
-	do {
-		byte_read = 0;
-		fret = f_read(&file, (void *)(dest), byte_to_read, &byte_read);
-		dest += byte_to_read;
-	} while (byte_read >= byte_to_read);
+	fret = f_stream(&file, dest, max, sdcard_consume, NULL, &byte_read);
+	if (fret == FR_DENIED) {
+		dbg_info("*** FATFS: [%s] is larger than %x bytes\n",
+			 filename, max);
+		ret = -1;
+		goto read_fail;
+	}
 
 	if (fret != FR_OK) {
 		dbg_info("*** FATFS: f_read: error\n");
@@ -60,7 +185,7 @@ static int sdcard_read_cmd(char *cmdline_file, char *cmdline_args)
 	FRESULT	fret;
         int 	ret;
 
-	fret = f_open(&file, cmdline_file, FA_OPEN_EXISTING | FA_READ);
+	fret = sdcard_open(&file, cmdline_file);
 	if (fret != FR_OK) {
 		dbg_info("*** FATFS: f_open, filename: [%s]: error %d\n",
 			  cmdline_file, fret);
@@ -124,27 +249,36 @@ int load_sdcard(struct image_info *image)
 		return -1;
 	}
 
+#ifdef CONFIG_OF_LIBFDT
+	if (sdcard_has_dt(image)) {
+		at91_board_set_dtb_name(image->of_filename);
+
+		if (strcmp(CONFIG_OF_OVERRIDE_DTB_NAME, "")) {
+			strcpy(image->of_filename, CONFIG_OF_OVERRIDE_DTB_NAME);
+		}
+	}
+#endif
+
+	sdcard_lookup(image);
+
 	dbg_info("SD/MMC: Image: Read file %s to %x\n",
 					image->filename, image->dest);
 
-	ret = sdcard_loadimage(image->filename, image->dest);
+	uimage_crc_start(image->dest);
+	ret = sdcard_loadimage(image->filename, image->dest,
+			       sdcard_window(image, image->dest));
 	if (ret) {
 		(void)f_mount(0, NULL);
 		return ret;
 	}
 
 #ifdef CONFIG_OF_LIBFDT
-	if (image->of_dest) {
-		at91_board_set_dtb_name(image->of_filename);
-
-		if (strcmp(CONFIG_OF_OVERRIDE_DTB_NAME, "")) {
-			strcpy(image->of_filename, CONFIG_OF_OVERRIDE_DTB_NAME);
-		}
-
+	if (sdcard_has_dt(image)) {
 		dbg_info("SD/MMC: dt blob: Read file %s to %x\n",
 				image->of_filename, image->of_dest);
 
-		ret = sdcard_loadimage(image->of_filename, image->of_dest);
+		ret = sdcard_loadimage(image->of_filename, image->of_dest,
+				       sdcard_window(image, image->of_dest));
 		if (ret) {
 			(void)f_mount(0, NULL);
 			return ret;
@@ -2,6 +2,7 @@
 //
 // SPDX-License-Identifier: MIT
 
+#include "common.h"
 #include "hardware.h"
 #include "board.h"
 #include "mci_media.h"
@@ -319,6 +320,88 @@ static void sdhc_set_power(void)
 	sdhc_writeb(SDMMC_PCR, value | SDMMC_PCR_SDBPWR);
 }
 
+/*
+ * SD clock obtained from the base clock, and the matching SDMMC divider,
+ * for the highest frequency not above the requested one
+ */
+static unsigned int sdhc_clock_divider(struct sd_host *host,
+				       unsigned int base,
+				       unsigned int clock,
+				       unsigned int *clk_div)
+{
+	unsigned int n;
+
+	if (host->caps_clk_mult) {
+		/* Programmable clock mode: base / (n + 1) */
+		n = div(base + clock - 1, clock);
+		if (n > 1024)
+			n = 1024;
+		*clk_div = n - 1;
+
+		return div(base, n);
+	}
+
+	/* Divided clock mode: base / 2n, or base itself when n is 0 */
+	if (base <= clock) {
+		*clk_div = 0;
+		return base;
+	}
+
+	n = div(base + 2 * clock - 1, 2 * clock);
+	if (n > 1023)
+		n = 1023;
+	*clk_div = n;
+
+	return div(base, 2 * n);
+}
+
+#ifdef CONFIG_SDHC_CLOCK_PLANNER
+/*
+ * Instead of only dividing the generic clock left by at91_sdhc_hw_init(),
+ * search the generic clock source and divider together with the SDMMC
+ * divider. The generic clock is kept at or below its initial rate.
+ */
+static const unsigned int sdhc_gck_sources[] = CONFIG_SYS_SDHC_GCK_SOURCES;
+
+static unsigned int sdhc_gck_max;
+static unsigned int sdhc_gck_css = 0xff;
+static unsigned int sdhc_gck_div;
+
+static unsigned int sdhc_plan_clock(struct sd_host *host, unsigned int clock,
+				    unsigned int *css, unsigned int *gck_div,
+				    unsigned int *clk_div)
+{
+	unsigned int best = 0;
+	unsigned int src, gck, rate, n, d, i;
+
+	for (i = 0; i < ARRAY_SIZE(sdhc_gck_sources); i++) {
+		src = pmc_get_generic_clock_source_rate(sdhc_gck_sources[i]);
+		if (!src)
+			continue;
+
+		for (d = div(src + sdhc_gck_max - 1, sdhc_gck_max);
+		     d <= 256; d++) {
+			gck = div(src, d);
+			rate = sdhc_clock_divider(host, gck, clock, &n);
+			if (rate > best) {
+				best = rate;
+				*css = sdhc_gck_sources[i];
+				*gck_div = d - 1;
+				*clk_div = n;
+				if (best == clock)
+					return best;
+			}
+
+			/* Dividing further can only lower the rate */
+			if (gck <= clock)
+				break;
+		}
+	}
+
+	return best;
+}
+#endif
+
 static int sdhc_set_clock(struct sd_card *sdcard, unsigned int clock)
 {
 	struct sd_host *host = sdcard->host;
@@ -326,6 +409,9 @@ static int sdhc_set_clock(struct sd_card *sdcard, unsigned int clock)
 	unsigned int clk_div;
 	unsigned int reg;
 	unsigned int timeout;
+#ifdef CONFIG_SDHC_CLOCK_PLANNER
+	unsigned int css, gck_div, rate;
+#endif
 
 	timeout = 100000;
 	while ((--timeout) &&
@@ -345,25 +431,27 @@ static int sdhc_set_clock(struct sd_card *sdcard, unsigned int clock)
 	if (clock < host->caps_min_clock)
 		clock = host->caps_min_clock;
 
-	if (host->caps_clk_mult) {
-		for (clk_div = 1; clk_div <= 1024; clk_div++) {
-			if (div(host->caps_max_clock, clk_div) <= clock)
-				break;
-		}
-		clk_gen_sel = SDMMC_CCR_CLKGSEL;
-		clk_div -= 1;
-	} else {
-		if (host->caps_max_clock <= clock) {
-			clk_div = 1;
-		} else {
-			for (clk_div = 2; clk_div < 2048; clk_div += 2) {
-				if (div(host->caps_max_clock, clk_div) <= clock)
-					break;
-			}
-		}
-		clk_div >>= 1;
+#ifdef CONFIG_SDHC_CLOCK_PLANNER
+	rate = sdhc_plan_clock(host, clock, &css, &gck_div, &clk_div);
+	if (!rate) {
+		dbg_info("SDHC: No clock setting for %d Hz\n", clock);
+		return -1;
+	}
+
+	if ((css != sdhc_gck_css) || (gck_div != sdhc_gck_div)) {
+		pmc_enable_generic_clock(CONFIG_SYS_ID_SDHC, css, gck_div);
+		sdhc_gck_css = css;
+		sdhc_gck_div = gck_div;
 	}
 
+	dbg_very_loud("SDHC: %d Hz requested, %d Hz set\n", clock, rate);
+#else
+	sdhc_clock_divider(host, host->caps_max_clock, clock, &clk_div);
+#endif
+
+	if (host->caps_clk_mult)
+		clk_gen_sel = SDMMC_CCR_CLKGSEL;
+
 	sdhc_writew(SDMMC_CCR, sdhc_readw(SDMMC_CCR) & ~SDMMC_CCR_SDCLKEN);
 
 	sdhc_writew(SDMMC_CCR, SDMMC_CCR_INTCLKEN | clk_gen_sel
@@ -434,6 +522,12 @@ static int sdhc_host_capability(struct sd_card *sdcard)
 	unsigned int caps;
 
 	host->caps_max_clock = pmc_get_generic_clock(CONFIG_SYS_ID_SDHC);
+#ifdef CONFIG_SDHC_CLOCK_PLANNER
+	/* The generic clock may have been changed by a previous init */
+	if (!sdhc_gck_max)
+		sdhc_gck_max = host->caps_max_clock;
+	host->caps_max_clock = sdhc_gck_max;
+#endif
 	host->caps_min_clock = host->caps_max_clock / 2048;
 
 	caps = sdhc_readl(SDMMC_CA0R);
@@ -9,6 +9,8 @@
 #include "string.h"
 #include "hardware.h"
 #include "arch/at91_ddrsdrc.h"
+#include "ddramc.h"
+#include "sdramc.h"
 #include "autoconf.h"
 
 static unsigned int cipher_key[8] = {
@@ -69,13 +71,19 @@ void ocms_enable(void)
 
 #endif /* #if defined(CONFIG_OCMS_STATIC) */
 
+/*
+ * The AES engine and the CMAC subkey are set up on the first use and kept
+ * until the keys are wiped, whatever the number of blocks checked.
+ */
+static at91_aes_ctx_t aes_ctx;
+static unsigned int aes_ready;
+
 static int secure_decrypt(void *data, unsigned int data_length, int is_signed)
 {
 	at91_aes_key_size_t key_size;
 	unsigned int computed_cmac[AT91_AES_BLOCK_SIZE_WORD];
 	unsigned int fixed_length;
 	const unsigned int *cmac;
-	int rc = -1;
 
 #if defined(CONFIG_AES_KEY_SIZE_128)
 	key_size = AT91_AES_KEY_SIZE_128;
@@ -88,43 +96,121 @@ static int secure_decrypt(void *data, unsigned int data_length, int is_signed)
 #endif
 
 	/* Init periph */
-	at91_aes_init();
+	if (!aes_ready) {
+		at91_aes_init(&aes_ctx, key_size);
+		aes_ready = 1;
+	}
 
 	/* Check signature if required */
 	if (is_signed) {
 		/* Compute the CMAC */
-		if (at91_aes_cmac(data_length, data, computed_cmac,
-				  key_size, cmac_key))
-			goto exit;
+		if (at91_aes_cmac(&aes_ctx, data_length, data, computed_cmac,
+				  cmac_key))
+			return -1;
 
 		/* Check the CMAC */
 		fixed_length = at91_aes_roundup(data_length);
 		cmac = (const unsigned int *)((char *)data + fixed_length);
 		if (!consttime_memequal(cmac, computed_cmac, AT91_AES_BLOCK_SIZE_BYTE))
-			goto exit;
+			return -1;
 	}
 
 	/* Decrypt the whole file */
-	if (at91_aes_cbc(data_length, data, data, 0,
-			 key_size, cipher_key, iv))
-		goto exit;
+	if (at91_aes_cbc(&aes_ctx, data_length, data, data, 0,
+			 cipher_key, iv))
+		return -1;
 
-	rc = 0;
-exit:
-	/* Reset periph */
-	at91_aes_cleanup();
-
-	return rc;
+	return 0;
 }
 
 static void __attribute__((optimize("O0"))) wipe_keys()
 {
+	/* Reset periph, along with the subkey */
+	if (aes_ready) {
+		at91_aes_cleanup(&aes_ctx);
+		aes_ready = 0;
+	}
+
 	/* Reset keys */
 	memset(cmac_key, 0, sizeof(cmac_key));
 	memset(cipher_key, 0, sizeof(cipher_key));
 	memset(iv, 0, sizeof(iv));
 }
 
+/*
+ * Room for the image at its destination: up to the DT blob when it is
+ * loaded above the image, else up to the end of the DRAM, and no more
+ * than the configured length when there is one.
+ */
+unsigned int secure_image_room(const struct image_info *image)
+{
+	unsigned int dest = (unsigned int)image->dest;
+	unsigned int end = AT91C_BASE_DDRCS;
+	unsigned int room;
+
+#if defined(CONFIG_SDRAM)
+	end += get_sdram_size();
+#elif defined(CONFIG_DDRC) || defined(CONFIG_UMCTL2)
+	end += get_ddram_size();
+#else
+#error "No DRAM type specified!"
+#endif
+
+#ifdef CONFIG_OF_LIBFDT
+	if (((unsigned int)image->of_dest > dest) &&
+	    ((unsigned int)image->of_dest < end))
+		end = (unsigned int)image->of_dest;
+#endif
+
+	room = (dest < end) ? end - dest : 0;
+
+#if defined(CONFIG_DATAFLASH) || defined(CONFIG_NANDFLASH) || defined(CONFIG_FLASH)
+	if (image->length && (image->length < room))
+		room = image->length;
+#endif
+
+	return room;
+}
+
+/*
+ * Decrypt a copy of the header, the first AES block of the image at data,
+ * and return the number of bytes to load: the header, the padded file and
+ * its CMAC. Called by the loaders before the bulk copy, so that a corrupt
+ * image is rejected early and no padding is read. max is the room at the
+ * destination, see secure_image_room().
+ */
+int secure_image_length(const void *data, unsigned int max)
+{
+	at91_secure_header_t header;
+	unsigned int length;
+
+	memcpy(&header, data, sizeof(header));
+
+	if (secure_decrypt(&header, sizeof(header), 0))
+		goto secure_error;
+
+	if (header.magic != AT91_SECURE_MAGIC) {
+		dbg_info("SECURE: bad image header\n");
+		goto secure_error;
+	}
+
+	length = sizeof(header) + at91_aes_roundup(header.file_size)
+		 + AT91_AES_BLOCK_SIZE_BYTE;
+	if ((length < header.file_size) || (length > max)) {
+		dbg_info("SECURE: image size %x does not fit\n",
+			 header.file_size);
+		goto secure_error;
+	}
+
+	memset(&header, 0, sizeof(header));
+	return length;
+
+secure_error:
+	memset(&header, 0, sizeof(header));
+	wipe_keys();
+	return -1;
+}
+
 int secure_check(void *data)
 {
 	const at91_secure_header_t *header;
@@ -12,13 +12,20 @@
 #include "timer.h"
 #include "div.h"
 #include "fdt.h"
+#include "secure.h"
 #include "debug.h"
 
+#ifdef CONFIG_DATAFLASH_AT45_POWER_2
+#include "usart.h"
+#endif
+
 /* Manufacturer Device ID Read */
 #define CMD_READ_DEV_ID			0x9f
 /* Continuous Array Read */
 #define CMD_READ_ARRAY_FAST		0x0b
 #define CMD_READ_ARRAY		0x03
+/* AT45DB-E Continuous Array Read, highest frequency, two dummy bytes */
+#define CMD_READ_ARRAY_HF_AT45		0x1b
 
 /* JEDEC Code */
 #define MANUFACTURER_ID_ATMEL		0x1f
@@ -52,6 +59,10 @@
 #define STATUS_PAGE_SIZE_AT45		(1 << 0)
 #define STATUS_READY_AT45		(1 << 7)
 
+/* AT45 "Power of 2" binary page size configuration sequence */
+#define CMD_CONFIG_AT45			0x3d
+#define CONFIG_POWER_2_AT45		0x2a, 0x80, 0xa6
+
 struct dataflash_descriptor {
 	unsigned char	family;
 
@@ -67,7 +78,7 @@ static int df_send_command(unsigned char *cmd,
 				unsigned char *data,
 				unsigned int data_len)
 {
-	int i;
+	int i, ret;
 
 	if (!cmd)
 		return -1;
@@ -89,13 +100,11 @@ static int df_send_command(unsigned char *cmd,
 		at91_spi_read_spi();
 	}
 
-	for (i = 0; i < data_len; i++) {
-		at91_spi_write_data(0);
-		*data++ = at91_spi_read_spi();
-	}
+	ret = at91_spi_read_data(data, data_len);
+
 	at91_spi_cs_deactivate();
 
-	return 0;
+	return ret;
 }
 
 static int dataflash_read_array(struct dataflash_descriptor *df_desc,
@@ -103,7 +112,7 @@ static int dataflash_read_array(struct dataflash_descriptor *df_desc,
 				unsigned int len,
 				void *buf)
 {
-	unsigned char cmd[5];
+	unsigned char cmd[7];
 	unsigned char cmd_len;
 	unsigned int address;
 	unsigned int page_addr = 0;
@@ -138,6 +147,12 @@ static int dataflash_read_array(struct dataflash_descriptor *df_desc,
 
 	cmd_len = 5;
 
+#ifdef CONFIG_DATAFLASH_AT45_READ_HF
+	/* same address phase, one more dummy byte */
+	cmd[0] = CMD_READ_ARRAY_HF_AT45;
+	cmd[cmd_len++] = 0x00;
+#endif
+
 	ret = df_send_command(cmd, cmd_len, buf, len);
 	if (ret)
 		return -1;
@@ -170,7 +185,21 @@ static int spinor_read_array(struct dataflash_descriptor *df_desc,
 	return 0;
 }
 
-static int read_array(struct dataflash_descriptor *df_desc,
+/* Set while the array reads run at CONFIG_SPI_READ_CLK */
+static int read_clk_fast;
+
+static int df_set_clock(unsigned int clock)
+{
+	if (at91_spi_init(AT91C_SPI_PCS_DATAFLASH, clock, CONFIG_SYS_SPI_MODE))
+		return -1;
+
+	at91_spi_enable();
+	read_clk_fast = (clock != CONFIG_SYS_SPI_CLOCK);
+
+	return 0;
+}
+
+static int read_array_once(struct dataflash_descriptor *df_desc,
 				unsigned int offset,
 				unsigned int len,
 				void *buf)
@@ -181,6 +210,30 @@ static int read_array(struct dataflash_descriptor *df_desc,
 		return spinor_read_array(df_desc, offset, len, buf);
 }
 
+/*
+ * A receive overrun at CONFIG_SPI_READ_CLK falls back to CONFIG_SPI_CLK
+ * for this read and the following ones.
+ */
+static int read_array(struct dataflash_descriptor *df_desc,
+				unsigned int offset,
+				unsigned int len,
+				void *buf)
+{
+	int ret;
+
+	ret = read_array_once(df_desc, offset, len, buf);
+	if (ret && read_clk_fast) {
+		dbg_info("SF: Overrun at the read clock, retry at %d Hz\n",
+			 CONFIG_SYS_SPI_CLOCK);
+		if (df_set_clock(CONFIG_SYS_SPI_CLOCK))
+			return -1;
+
+		ret = read_array_once(df_desc, offset, len, buf);
+	}
+
+	return ret;
+}
+
 #if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
 static int update_image_length(struct dataflash_descriptor *df_desc,
 				unsigned int offset,
@@ -455,6 +508,52 @@ static int df_n25q_desc_init(struct dataflash_descriptor *df_desc)
 	return 0;
 }
 
+#ifdef CONFIG_DATAFLASH_AT45_POWER_2
+static int dataflash_at45_power_2(void)
+{
+	unsigned char cmd[4] = { CMD_CONFIG_AT45, CONFIG_POWER_2_AT45 };
+	unsigned char status;
+	unsigned int timeout = 1000;
+	int ret;
+
+	ret = df_send_command(cmd, 4, NULL, 0);
+	if (ret)
+		return ret;
+
+	do {
+		udelay(100);
+		ret = df_read_status_at45(&status);
+		if (ret)
+			return ret;
+	} while (!(status & STATUS_READY_AT45) && --timeout);
+
+	if (!(status & STATUS_READY_AT45))
+		return -1;
+
+	return 0;
+}
+
+/*
+ * Provisioning build: switch an AT45 in DataFlash page size to binary
+ * page size, report and stop. No image is loaded, the flash must be
+ * programmed again after the next power cycle.
+ */
+static void dataflash_at45_provision(struct dataflash_descriptor *df_desc)
+{
+	if (df_desc->family != DF_FAMILY_AT45)
+		usart_puts("SF: not an AT45 DataFlash, nothing to do\n");
+	else if (df_desc->is_power_2)
+		usart_puts("SF: AT45 already in binary page size\n");
+	else if (dataflash_at45_power_2())
+		usart_puts("SF: AT45 page size configuration failed\n");
+	else
+		usart_puts("SF: AT45 set to binary page size, "
+			   "power cycle and program the flash again\n");
+
+	while (1);
+}
+#endif
+
 static int df_at45_desc_init(struct dataflash_descriptor *df_desc)
 {
 	unsigned char status;
@@ -638,13 +737,26 @@ static int dataflash_probe_atmel(struct dataflash_descriptor *df_desc)
 	return 0;
 }
 
+/* Realized array read throughput, in KB/s */
+static unsigned int read_throughput(unsigned int len, unsigned int ticks)
+{
+	unsigned int ms = div(ticks, div(timer_get_rate(), 1000));
+
+	if (!ms)
+		ms = 1;
+
+	return div((len >> 10) * 1000, ms);
+}
+
 int spi_flash_loadimage(struct image_info *image)
 {
 	struct dataflash_descriptor	df_descriptor;
 	struct dataflash_descriptor	*df_desc = &df_descriptor;
+	unsigned int start;
 	int ret = 0;
 
 	memset(df_desc, 0, sizeof(*df_desc));
+	read_clk_fast = 0;
 
 	at91_spi0_hw_init();
 
@@ -664,6 +776,10 @@ int spi_flash_loadimage(struct image_info *image)
 		goto err_exit;
 	}
 
+#ifdef CONFIG_DATAFLASH_AT45_POWER_2
+	dataflash_at45_provision(df_desc);
+#endif
+
 #ifdef CONFIG_DATAFLASH_RECOVERY
 	if (!dataflash_recovery(df_desc)) {
 		ret = -2;
@@ -671,7 +787,30 @@ int spi_flash_loadimage(struct image_info *image)
 	}
 #endif
 
-#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+	/* Only the array reads may run faster than SPI_CLK */
+	if (CONFIG_SPI_READ_CLK != CONFIG_SYS_SPI_CLOCK) {
+		ret = df_set_clock(CONFIG_SPI_READ_CLK);
+		if (ret) {
+			dbg_info("SF: Fail to set the read clock\n");
+			ret = -1;
+			goto err_exit;
+		}
+	}
+
+#if defined(CONFIG_SECURE)
+	int length;
+
+	ret = read_array(df_desc, image->offset,
+			 sizeof(at91_secure_header_t), image->dest);
+	length = ret ? -1 : secure_image_length(image->dest,
+						secure_image_room(image));
+	if (length == -1) {
+		ret = -1;
+		goto err_exit;
+	}
+
+	image->length = length;
+#elif defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
 	int length = update_image_length(df_desc,
 				image->offset, image->dest, KERNEL_IMAGE);
 	if (length == -1)
@@ -683,6 +822,7 @@ int spi_flash_loadimage(struct image_info *image)
 	dbg_info("SF: Copy %x bytes from %x to %x\n",
 			image->length, image->offset, image->dest);
 
+	start = timer_get_ticks();
 	ret = read_array(df_desc, image->offset, image->length, image->dest);
 	if (ret) {
 		dbg_info("** SF: Serial flash read error**\n");
@@ -690,6 +830,9 @@ int spi_flash_loadimage(struct image_info *image)
 		goto err_exit;
 	}
 
+	dbg_info("SF: Read at %d KB/s\n",
+		 read_throughput(image->length, timer_get_ticks() - start));
+
 #ifdef CONFIG_OF_LIBFDT
 	length = update_image_length(df_desc,
 			image->of_offset, image->of_dest, DT_BLOB);
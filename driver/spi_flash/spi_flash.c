@@ -10,6 +10,7 @@
 #include "timer.h"
 #include "div.h"
 #include "fdt.h"
+#include "secure.h"
 
 int spi_flash_read_reg(struct spi_flash *flash, u8 inst, u8 *buf, size_t len)
 {
@@ -288,7 +289,8 @@ int spi_flash_recovery(struct spi_flash *flash)
 
 int spi_flash_loadimage(struct spi_flash *flash, struct image_info *image)
 {
-#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID) || \
+    defined(CONFIG_SECURE)
 	int length;
 #endif
 	int ret = 0;
@@ -337,7 +339,20 @@ int spi_flash_loadimage(struct spi_flash *flash, struct image_info *image)
 	return 0;
 #else /* CONFIG_QSPI_XIP */
 
-#if defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
+#if defined(CONFIG_SECURE)
+	ret = spi_flash_read(flash,
+			     image->offset,
+			     sizeof(at91_secure_header_t),
+			     image->dest);
+	length = ret ? -1 : secure_image_length(image->dest,
+						secure_image_room(image));
+	if (length == -1) {
+		ret = -1;
+		goto err_exit;
+	}
+
+	image->length = length;
+#elif defined(CONFIG_LOAD_LINUX) || defined(CONFIG_LOAD_ANDROID)
 	length = update_image_length(flash,
 				     image->offset,
 				     image->dest,
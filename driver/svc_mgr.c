@@ -2,6 +2,8 @@
 //
 // SPDX-License-Identifier: MIT
 
+#include "common.h"
+#include "string.h"
 #include "svc_mgr.h"
 #include "arch/at91_pmc/pmc.h"
 #include "pmc.h"
@@ -11,111 +13,257 @@
 #include "rstc.h"
 #include "watchdog.h"
 
-/*
- * svc_mgr_main - C entry point of the secure world when a SMC is processed
- * in Normal World
- */
-int svc_mgr_main(struct smc_args_t const *args)
+static int smc_pmc_pck_setup(struct smc_args_t const *args)
 {
-	int ret = 0;
 	unsigned int pck_mask;
-	unsigned int silent = 1;
 
-	dbg_loud("--> svc_mgr_main\n");
-
-	switch (args->r0) {
-	case 0x24:
-		if (args->r1 == PMC_PLLAR
-			|| args->r1 == PMC_MCKR
-			|| args->r1 == PMC_PCKR
-			|| args->r1 == PMC_PCKR1
-			|| args->r1 == PMC_PCKR2)
-			ret = pmc_read_reg(args->r1);
-		else
-			ret = -1;
+	switch (args->r1) {
+	case PMC_PCKR:
+		pck_mask = AT91C_PMC_PCK0;
 		break;
-
-	case 0x25:
-		if (is_peripheral_secure(args->r1))
-			ret = -1;
-		else if (is_switching_clock_forbiden(args->r1, args->r2, &silent))
-			if (silent)
-				ret = 0;
-			else
-				ret = -1;
-		else
-			ret = pmc_periph_clk(args->r1, args->r2);
+	case PMC_PCKR1:
+		pck_mask = AT91C_PMC_PCK1;
 		break;
-
-	case 0x26:
-		if (is_sys_clk_secure(args->r1) && is_pck_clk_secure(args->r1))
-			ret = -1;
-		else
-			ret = pmc_sys_clk(args->r1, args->r2);
+	case PMC_PCKR2:
+		pck_mask = AT91C_PMC_PCK2;
 		break;
+	default:
+		return -1;
+	}
 
-	case 0x27:
-		if (is_usb_hs_secure())
-			ret = -1;
-		else
-			ret = pmc_uckr_clk(args->r1);
-		break;
+	if (is_pck_clk_secure(pck_mask))
+		return -1;
 
-	case 0x28:
-		if (is_usb_host_secure())
-			ret = -1;
-		else
-			ret = pmc_usb_setup();
-		break;
-	case 0x29:
-		cpu_reset();
-
-	case 0x23:
-		switch (args->r1) {
-		case PMC_PCKR:
-			pck_mask = AT91C_PMC_PCK0;
-			break;
-		case PMC_PCKR1:
-			pck_mask = AT91C_PMC_PCK1;
-			break;
-		case PMC_PCKR2:
-			pck_mask = AT91C_PMC_PCK2;
-			break;
-		default:
-			return -1;
-		}
-
-		if (is_pck_clk_secure(pck_mask)) {
-			ret = -1;
-		} else {
-			pmc_pck_setup(args->r1, args->r2);
-			ret = 0;
-		}
-		break;
+	pmc_pck_setup(args->r1, args->r2);
 
-	case 0x42:
-		l2cache_enable();
-		break;
-	case 0x50:
-		pmc_smd_setup(args->r1);
-		break;
+	return 0;
+}
 
-	case 0x60:
-		ret = at91_wdt_set_counter(args->r1);
-		break;
+static int smc_pmc_read_reg(struct smc_args_t const *args)
+{
+	if (args->r1 == PMC_PLLAR
+		|| args->r1 == PMC_MCKR
+		|| args->r1 == PMC_PCKR
+		|| args->r1 == PMC_PCKR1
+		|| args->r1 == PMC_PCKR2)
+		return pmc_read_reg(args->r1);
 
-	case 0x61:
-		ret = at91_wdt_reload_counter();
-		break;
+	return -1;
+}
+
+static int smc_pmc_periph_clk(struct smc_args_t const *args)
+{
+	unsigned int silent = 1;
+
+	if (is_peripheral_secure(args->r1))
+		return -1;
+
+	if (is_switching_clock_forbiden(args->r1, args->r2, &silent))
+		return silent ? 0 : -1;
+
+	return pmc_periph_clk(args->r1, args->r2);
+}
+
+static int smc_pmc_sys_clk(struct smc_args_t const *args)
+{
+	if (is_sys_clk_secure(args->r1) && is_pck_clk_secure(args->r1))
+		return -1;
+
+	return pmc_sys_clk(args->r1, args->r2);
+}
+
+static int smc_pmc_uckr_clk(struct smc_args_t const *args)
+{
+	if (is_usb_hs_secure())
+		return -1;
+
+	return pmc_uckr_clk(args->r1);
+}
+
+static int smc_pmc_usb_setup(struct smc_args_t const *args)
+{
+	if (is_usb_host_secure())
+		return -1;
+
+	return pmc_usb_setup();
+}
+
+static int smc_cpu_reset(struct smc_args_t const *args)
+{
+	cpu_reset();
+
+	return 0;
+}
+
+static int smc_l2cache_enable(struct smc_args_t const *args)
+{
+	l2cache_enable();
+
+	return 0;
+}
+
+static int smc_pmc_smd_setup(struct smc_args_t const *args)
+{
+	pmc_smd_setup(args->r1);
+
+	return 0;
+}
 
+static int smc_wdt_set_counter(struct smc_args_t const *args)
+{
+	return at91_wdt_set_counter(args->r1);
+}
+
+static int smc_wdt_reload_counter(struct smc_args_t const *args)
+{
+	return at91_wdt_reload_counter();
+}
+
+#ifdef CONFIG_SVC_MGR_STATS
+static int smc_stats_read(struct smc_args_t const *args);
+static int smc_stats_reset(struct smc_args_t const *args);
+#endif
+
+#define SMC_ID_FIRST		SMC_PMC_PCK_SETUP
+#ifdef CONFIG_SVC_MGR_STATS
+#define SMC_ID_LAST		SMC_STATS_RESET
+#else
+#define SMC_ID_LAST		SMC_WDT_RELOAD_COUNTER
+#endif
+#define SMC_ID_COUNT		(SMC_ID_LAST - SMC_ID_FIRST + 1)
+
+typedef int (*smc_handler_t)(struct smc_args_t const *args);
+
+/* Indexed by SMC ID - SMC_ID_FIRST, NULL for the IDs not handled */
+static const smc_handler_t smc_handlers[SMC_ID_COUNT] = {
+	[SMC_PMC_PCK_SETUP - SMC_ID_FIRST]	= smc_pmc_pck_setup,
+	[SMC_PMC_READ_REG - SMC_ID_FIRST]	= smc_pmc_read_reg,
+	[SMC_PMC_PERIPH_CLK - SMC_ID_FIRST]	= smc_pmc_periph_clk,
+	[SMC_PMC_SYS_CLK - SMC_ID_FIRST]	= smc_pmc_sys_clk,
+	[SMC_PMC_UCKR_CLK - SMC_ID_FIRST]	= smc_pmc_uckr_clk,
+	[SMC_PMC_USB_SETUP - SMC_ID_FIRST]	= smc_pmc_usb_setup,
+	[SMC_CPU_RESET - SMC_ID_FIRST]		= smc_cpu_reset,
+	[SMC_L2CACHE_ENABLE - SMC_ID_FIRST]	= smc_l2cache_enable,
+	[SMC_PMC_SMD_SETUP - SMC_ID_FIRST]	= smc_pmc_smd_setup,
+	[SMC_WDT_SET_COUNTER - SMC_ID_FIRST]	= smc_wdt_set_counter,
+	[SMC_WDT_RELOAD_COUNTER - SMC_ID_FIRST]	= smc_wdt_reload_counter,
+#ifdef CONFIG_SVC_MGR_STATS
+	[SMC_STATS_READ - SMC_ID_FIRST]		= smc_stats_read,
+	[SMC_STATS_RESET - SMC_ID_FIRST]	= smc_stats_reset,
+#endif
+};
+
+static int smc_find(unsigned int id)
+{
+	if ((id < SMC_ID_FIRST) || (id > SMC_ID_LAST))
+		return -1;
+
+	if (!smc_handlers[id - SMC_ID_FIRST])
+		return -1;
+
+	return id - SMC_ID_FIRST;
+}
+
+#ifdef CONFIG_SVC_MGR_STATS
+struct smc_stats {
+	unsigned int	count;
+	unsigned int	timed;
+	unsigned int	cycles;
+	unsigned int	max_cycles;
+};
+
+static struct smc_stats smc_stats[SMC_ID_COUNT];
+
+/*
+ * The latency is read from the PMU cycle counter, which belongs to the
+ * Normal World: it is only used while running undivided there, the PMU
+ * settings are never touched.
+ */
+static int cycle_counter_running(void)
+{
+	unsigned int pmcr, pmcntenset;
+
+	asm volatile ("mrc	p15, 0, %0, c9, c12, 0" : "=r" (pmcr));
+	asm volatile ("mrc	p15, 0, %0, c9, c12, 1" : "=r" (pmcntenset));
+
+	return ((pmcr & 0x9) == 0x1) && (pmcntenset & 0x80000000);
+}
+
+static inline unsigned int cycle_counter_read(void)
+{
+	unsigned int cycles;
+
+	asm volatile ("mrc	p15, 0, %0, c9, c13, 0" : "=r" (cycles));
+
+	return cycles;
+}
+
+static int smc_stats_read(struct smc_args_t const *args)
+{
+	int i = smc_find(args->r1);
+
+	if (i < 0)
+		return -1;
+
+	switch (args->r2) {
+	case SMC_STATS_COUNT:
+		return smc_stats[i].count;
+	case SMC_STATS_TIMED:
+		return smc_stats[i].timed;
+	case SMC_STATS_CYCLES:
+		return smc_stats[i].cycles;
+	case SMC_STATS_MAX_CYCLES:
+		return smc_stats[i].max_cycles;
 	default:
+		return -1;
+	}
+}
+
+static int smc_stats_reset(struct smc_args_t const *args)
+{
+	memset(smc_stats, 0, sizeof(smc_stats));
+
+	return 0;
+}
+#endif /* CONFIG_SVC_MGR_STATS */
+
+/*
+ * svc_mgr_main - C entry point of the secure world when a SMC is processed
+ * in Normal World
+ */
+int svc_mgr_main(struct smc_args_t const *args)
+{
+	int i = smc_find(args->r0);
+	int ret;
+#ifdef CONFIG_SVC_MGR_STATS
+	unsigned int start = 0, cycles;
+	int timed;
+#endif
+
+	if (i < 0) {
 		dbg_info("svc mgr error: SMC ID (%d) not defined\n",
 							args->r0);
-		ret = -1;
-		break;
+		return -1;
 	}
 
-	dbg_loud("<-- svc_mgr_main\n");
+#ifdef CONFIG_SVC_MGR_STATS
+	timed = cycle_counter_running();
+	if (timed)
+		start = cycle_counter_read();
+#endif
+
+	ret = (*smc_handlers[i])(args);
+
+#ifdef CONFIG_SVC_MGR_STATS
+	smc_stats[i].count++;
+	if (timed) {
+		cycles = cycle_counter_read() - start;
+		smc_stats[i].timed++;
+		smc_stats[i].cycles += cycles;
+		if (cycles > smc_stats[i].max_cycles)
+			smc_stats[i].max_cycles = cycles;
+	}
+#endif
 
 	return ret;
 }
@@ -4,6 +4,7 @@
 
 #include "mon_macros.h"
 #include "mon.h"
+#include "matrix.h"
 #include "debug.h"
 
 void dacr_swd_init(void)
@@ -30,6 +31,9 @@ void cpacr_init(void)
 
 void enter_normal_world(void)
 {
+	/* SPSELR is read-only from the Normal World */
+	matrix_cache_peri_security();
+
 	asm volatile ("smc #0");
 }
 
@@ -0,0 +1,639 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "common.h"
+#include "hardware.h"
+#include "board.h"
+#include "nand.h"
+#include "crc32.h"
+#include "div.h"
+#include "string.h"
+#include "debug.h"
+#include "ubi.h"
+
+/*
+ * Read-only access to the static volumes of an UBI partition.
+ *
+ * The volumes are attached from the fastmap when there is a valid one,
+ * only the PEBs of its pools being scanned for LEBs written since. Else
+ * the VID header of every PEB is read, the page holding it only.
+ */
+
+#define UBI_EC_HDR_MAGIC	0x55424923	/* "UBI#" */
+#define UBI_VID_HDR_MAGIC	0x55424921	/* "UBI!" */
+#define UBI_HDR_SIZE		64
+#define UBI_HDR_SIZE_CRC	(UBI_HDR_SIZE - 4)
+
+#define UBI_VID_STATIC		2
+
+#define UBI_FM_SB_VOLUME_ID	0x7ffff000
+#define UBI_FM_DATA_VOLUME_ID	0x7ffff001
+
+#define UBI_FM_SB_MAGIC		0x7b11d69f
+#define UBI_FM_HDR_MAGIC	0xd4b82ef7
+#define UBI_FM_VHDR_MAGIC	0xfa370ed1
+#define UBI_FM_POOL_MAGIC	0x67af4d08
+#define UBI_FM_EBA_MAGIC	0xf0c040a8
+
+#define UBI_FM_FMT_VERSION	2
+#define UBI_FM_MAX_START	64	/* the anchor is in the first PEBs */
+#define UBI_FM_MAX_BLOCKS	32
+#define UBI_FM_MAX_POOL_SIZE	256
+
+#define UBI_NO_PEB		0xffff
+
+/* The last page of a LEB, read with its spare area for the software ECC */
+#define UBI_MAX_SECTOR_SIZE	(4096 + 256)
+
+/* On flash structures, big endian */
+struct ubi_ec_hdr {
+	unsigned int	magic;
+	unsigned char	version;
+	unsigned char	padding1[3];
+	unsigned int	ec[2];
+	unsigned int	vid_hdr_offset;
+	unsigned int	data_offset;
+	unsigned int	image_seq;
+	unsigned char	padding2[32];
+	unsigned int	hdr_crc;
+};
+
+struct ubi_vid_hdr {
+	unsigned int	magic;
+	unsigned char	version;
+	unsigned char	vol_type;
+	unsigned char	copy_flag;
+	unsigned char	compat;
+	unsigned int	vol_id;
+	unsigned int	lnum;
+	unsigned char	padding1[4];
+	unsigned int	data_size;
+	unsigned int	used_ebs;
+	unsigned int	data_pad;
+	unsigned int	data_crc;
+	unsigned char	padding2[4];
+	unsigned int	sqnum[2];	/* 64 bits, high word first */
+	unsigned char	padding3[12];
+	unsigned int	hdr_crc;
+};
+
+struct ubi_fm_sb {
+	unsigned int	magic;
+	unsigned char	version;
+	unsigned char	padding1[3];
+	unsigned int	data_crc;
+	unsigned int	used_blocks;
+	unsigned int	block_loc[UBI_FM_MAX_BLOCKS];
+	unsigned int	block_ec[UBI_FM_MAX_BLOCKS];
+	unsigned int	sqnum[2];
+	unsigned char	padding2[32];
+};
+
+struct ubi_fm_hdr {
+	unsigned int	magic;
+	unsigned int	free_pebs;
+	unsigned int	used_pebs;
+	unsigned int	scrub_pebs;
+	unsigned int	bad_pebs;
+	unsigned int	erase_pebs;
+	unsigned int	vol_count;
+	unsigned char	padding[4];
+};
+
+struct ubi_fm_scan_pool {
+	unsigned int	magic;
+	unsigned short	size;
+	unsigned short	max_size;
+	unsigned int	pebs[UBI_FM_MAX_POOL_SIZE];
+	unsigned int	padding[4];
+};
+
+struct ubi_fm_ec {
+	unsigned int	pnum;
+	unsigned int	ec;
+};
+
+struct ubi_fm_volhdr {
+	unsigned int	magic;
+	unsigned int	vol_id;
+	unsigned char	vol_type;
+	unsigned char	padding1[3];
+	unsigned int	data_pad;
+	unsigned int	used_ebs;
+	unsigned int	last_eb_bytes;
+	unsigned char	padding2[8];
+};
+
+struct ubi_fm_eba {
+	unsigned int	magic;
+	unsigned int	reserved_pebs;
+	unsigned int	pnum[];
+};
+
+/*
+ * LEB to PEB map of a volume. Only the low word of the sequence numbers
+ * is kept, the LEBs mapped by the fastmap having 0.
+ */
+struct ubi_volume {
+	unsigned int	vol_id;
+	unsigned int	used_ebs;
+	unsigned int	data_pad;
+	unsigned int	last_eb_bytes;
+	unsigned int	used_sqnum;	/* of the header used_ebs is from */
+	unsigned short	peb[CONFIG_UBI_MAX_LEBS];
+	unsigned int	sqnum[CONFIG_UBI_MAX_LEBS];
+};
+
+/*
+ * The scratch buffer is in the external RAM, where the kernel is loaded
+ * once attached: a page for the headers, a LEB to check the copies and
+ * the fastmap after them.
+ */
+struct ubi_device {
+	struct nand_info	*nand;
+	unsigned int		first_block;
+	unsigned int		peb_count;
+	unsigned int		vid_hdr_offset;
+	unsigned int		data_offset;
+	unsigned int		leb_size;
+	unsigned char		*buf;
+	struct ubi_volume	*vols;
+	unsigned int		nvols;
+};
+
+#ifdef CONFIG_OF_LIBFDT
+static struct ubi_volume ubi_vols[2];
+#else
+static struct ubi_volume ubi_vols[1];
+#endif
+
+static unsigned int ubi_page[UBI_MAX_SECTOR_SIZE / 4];
+
+/* UBI seeds the CRC32 with ~0 and does not invert the result */
+static unsigned int ubi_crc(const void *buf, unsigned int len)
+{
+	return ~crc32(0, (const unsigned char *)buf, len);
+}
+
+static unsigned int ubi_be16(unsigned short data)
+{
+	return ((data & 0xff) << 8) | (data >> 8);
+}
+
+static void *ubi_read_hdr(struct ubi_device *ubi,
+			  unsigned int pnum,
+			  unsigned int offset)
+{
+	unsigned int page, column;
+
+	division(offset, ubi->nand->pagesize, &page, &column);
+
+	if (nand_read_block_pages(ubi->nand, ubi->first_block + pnum,
+				  page, 1, ubi->buf))
+		return NULL;
+
+	return ubi->buf + column;
+}
+
+static struct ubi_vid_hdr *ubi_read_vid_hdr(struct ubi_device *ubi,
+					    unsigned int pnum)
+{
+	struct ubi_vid_hdr *vid;
+
+	vid = ubi_read_hdr(ubi, pnum, ubi->vid_hdr_offset);
+	if (!vid || (swap_uint32(vid->magic) != UBI_VID_HDR_MAGIC))
+		return NULL;
+
+	if (ubi_crc(vid, UBI_HDR_SIZE_CRC) != swap_uint32(vid->hdr_crc))
+		return NULL;
+
+	return vid;
+}
+
+/*
+ * Read the first len bytes of the data of a LEB. A partial last page
+ * goes through ubi_page, so that nothing is written past dest + len.
+ */
+static int ubi_read_leb(struct ubi_device *ubi,
+			unsigned int pnum,
+			unsigned char *dest,
+			unsigned int len)
+{
+	unsigned int block = ubi->first_block + pnum;
+	unsigned int page = div(ubi->data_offset, ubi->nand->pagesize);
+	unsigned int numpages, tail;
+
+	division(len, ubi->nand->pagesize, &numpages, &tail);
+
+	if (numpages && nand_read_block_pages(ubi->nand, block, page,
+					      numpages, dest))
+		return -1;
+
+	if (!tail)
+		return 0;
+
+	if (nand_read_block_pages(ubi->nand, block, page + numpages, 1,
+				  (unsigned char *)ubi_page))
+		return -1;
+
+	memcpy(dest + len - tail, ubi_page, tail);
+
+	return 0;
+}
+
+/* The header offsets are the same in all the PEBs, take the first ones */
+static int ubi_read_geometry(struct ubi_device *ubi)
+{
+	struct nand_info *nand = ubi->nand;
+	struct ubi_ec_hdr *ec;
+	unsigned int pnum;
+
+	for (pnum = 0; pnum < ubi->peb_count; pnum++) {
+		ec = ubi_read_hdr(ubi, pnum, 0);
+		if (!ec || (swap_uint32(ec->magic) != UBI_EC_HDR_MAGIC))
+			continue;
+
+		if (ubi_crc(ec, UBI_HDR_SIZE_CRC) != swap_uint32(ec->hdr_crc))
+			continue;
+
+		ubi->vid_hdr_offset = swap_uint32(ec->vid_hdr_offset);
+		ubi->data_offset = swap_uint32(ec->data_offset);
+
+		if ((ubi->data_offset >= nand->blocksize)
+		    || mod(ubi->data_offset, nand->pagesize)
+		    || (ubi->vid_hdr_offset + UBI_HDR_SIZE > ubi->data_offset))
+			return -1;
+
+		if (nand->sectorsize > sizeof(ubi_page)) {
+			dbg_info("UBI: %d byte pages not supported\n",
+				 nand->pagesize);
+			return -1;
+		}
+
+		ubi->leb_size = nand->blocksize - ubi->data_offset;
+
+		return 0;
+	}
+
+	return -1;
+}
+
+static void ubi_init_volumes(struct ubi_device *ubi)
+{
+	struct ubi_volume *vol;
+	unsigned int i, lnum;
+
+	for (i = 0; i < ubi->nvols; i++) {
+		vol = &ubi->vols[i];
+		vol->used_ebs = 0;
+		vol->data_pad = 0;
+		vol->last_eb_bytes = 0;
+		vol->used_sqnum = 0;
+		for (lnum = 0; lnum < CONFIG_UBI_MAX_LEBS; lnum++) {
+			vol->peb[lnum] = UBI_NO_PEB;
+			vol->sqnum[lnum] = 0;
+		}
+	}
+}
+
+static struct ubi_volume *ubi_find_volume(struct ubi_device *ubi,
+					  unsigned int vol_id)
+{
+	unsigned int i;
+
+	for (i = 0; i < ubi->nvols; i++)
+		if (ubi->vols[i].vol_id == vol_id)
+			return &ubi->vols[i];
+
+	return NULL;
+}
+
+/* A LEB copy interrupted by a power cut has a wrong data CRC */
+static int ubi_check_copy(struct ubi_device *ubi,
+			  unsigned int pnum,
+			  unsigned int data_size,
+			  unsigned int data_crc)
+{
+	unsigned char *data = ubi->buf + ubi->nand->blocksize;
+
+	if (data_size > ubi->leb_size)
+		return -1;
+
+	if (ubi_read_leb(ubi, pnum, data, data_size))
+		return -1;
+
+	return (ubi_crc(data, data_size) == data_crc) ? 0 : -1;
+}
+
+/* Map the LEB a VID header is for, unless a newer copy is known */
+static void ubi_add_leb(struct ubi_device *ubi,
+			struct ubi_vid_hdr *vid,
+			unsigned int pnum)
+{
+	struct ubi_volume *vol;
+	unsigned int lnum = swap_uint32(vid->lnum);
+	unsigned int sqnum = swap_uint32(vid->sqnum[1]);
+	unsigned int used_ebs = swap_uint32(vid->used_ebs);
+	unsigned int data_size = swap_uint32(vid->data_size);
+	unsigned int data_crc = swap_uint32(vid->data_crc);
+	unsigned int data_pad = swap_uint32(vid->data_pad);
+	unsigned int copy_flag = vid->copy_flag;
+
+	vol = ubi_find_volume(ubi, swap_uint32(vid->vol_id));
+	if (!vol || (vid->vol_type != UBI_VID_STATIC))
+		return;
+
+	if (lnum >= CONFIG_UBI_MAX_LEBS) {
+		dbg_info("UBI: volume %d: LEB %d over UBI_MAX_LEBS\n",
+			 vol->vol_id, lnum);
+		return;
+	}
+
+	if ((vol->peb[lnum] != UBI_NO_PEB) && (sqnum <= vol->sqnum[lnum]))
+		return;
+
+	/* the header is in the scratch buffer, now read from */
+	if (copy_flag && ubi_check_copy(ubi, pnum, data_size, data_crc))
+		return;
+
+	if (nand_check_badblock(ubi->nand, ubi->first_block + pnum, ubi->buf))
+		return;
+
+	vol->peb[lnum] = pnum;
+	vol->sqnum[lnum] = sqnum;
+
+	if (sqnum >= vol->used_sqnum) {
+		vol->used_ebs = used_ebs;
+		vol->data_pad = data_pad;
+		vol->used_sqnum = sqnum;
+	}
+
+	if (lnum == used_ebs - 1)
+		vol->last_eb_bytes = data_size;
+}
+
+static int ubi_parse_fastmap(struct ubi_device *ubi,
+			     unsigned char *fm,
+			     unsigned int fm_size)
+{
+	struct ubi_fm_hdr *hdr;
+	struct ubi_fm_scan_pool *pools[2];
+	struct ubi_fm_volhdr *vhdr;
+	struct ubi_fm_eba *eba;
+	struct ubi_volume *vol;
+	struct ubi_vid_hdr *vid;
+	unsigned int pos = sizeof(struct ubi_fm_sb);
+	unsigned int i, j, n, lebs, pnum;
+
+	hdr = (struct ubi_fm_hdr *)(fm + pos);
+	pos += sizeof(*hdr);
+	if (swap_uint32(hdr->magic) != UBI_FM_HDR_MAGIC)
+		return -1;
+
+	for (i = 0; i < 2; i++) {
+		pools[i] = (struct ubi_fm_scan_pool *)(fm + pos);
+		pos += sizeof(struct ubi_fm_scan_pool);
+		if (swap_uint32(pools[i]->magic) != UBI_FM_POOL_MAGIC)
+			return -1;
+	}
+
+	/* the erase counters of the free, used, scrub and erase lists */
+	pos += (swap_uint32(hdr->free_pebs) + swap_uint32(hdr->used_pebs)
+		+ swap_uint32(hdr->scrub_pebs) + swap_uint32(hdr->erase_pebs))
+		* sizeof(struct ubi_fm_ec);
+
+	for (i = 0; i < swap_uint32(hdr->vol_count); i++) {
+		if (pos + sizeof(*vhdr) + sizeof(*eba) > fm_size)
+			return -1;
+
+		vhdr = (struct ubi_fm_volhdr *)(fm + pos);
+		pos += sizeof(*vhdr);
+		eba = (struct ubi_fm_eba *)(fm + pos);
+		pos += sizeof(*eba);
+
+		if ((swap_uint32(vhdr->magic) != UBI_FM_VHDR_MAGIC)
+		    || (swap_uint32(eba->magic) != UBI_FM_EBA_MAGIC))
+			return -1;
+
+		n = swap_uint32(eba->reserved_pebs);
+		if (n > div(fm_size - pos, sizeof(unsigned int)))
+			return -1;
+		pos += n * sizeof(unsigned int);
+
+		vol = ubi_find_volume(ubi, swap_uint32(vhdr->vol_id));
+		if (!vol || (vhdr->vol_type != UBI_VID_STATIC))
+			continue;
+
+		lebs = swap_uint32(vhdr->used_ebs);
+		if (lebs > CONFIG_UBI_MAX_LEBS)
+			lebs = CONFIG_UBI_MAX_LEBS;
+		if (lebs > n)
+			lebs = n;
+
+		vol->used_ebs = swap_uint32(vhdr->used_ebs);
+		vol->data_pad = swap_uint32(vhdr->data_pad);
+		vol->last_eb_bytes = swap_uint32(vhdr->last_eb_bytes);
+
+		for (j = 0; j < lebs; j++) {
+			pnum = swap_uint32(eba->pnum[j]);
+			if (pnum < ubi->peb_count)
+				vol->peb[j] = pnum;
+		}
+	}
+
+	/* LEBs written since the fastmap are in PEBs of the pools */
+	for (i = 0; i < 2; i++) {
+		n = ubi_be16(pools[i]->size);
+		if (n > UBI_FM_MAX_POOL_SIZE)
+			return -1;
+
+		for (j = 0; j < n; j++) {
+			pnum = swap_uint32(pools[i]->pebs[j]);
+			if (pnum >= ubi->peb_count)
+				continue;
+
+			vid = ubi_read_vid_hdr(ubi, pnum);
+			if (vid)
+				ubi_add_leb(ubi, vid, pnum);
+		}
+	}
+
+	return 0;
+}
+
+static int ubi_attach_fastmap(struct ubi_device *ubi)
+{
+	unsigned char *fm = ubi->buf + 2 * ubi->nand->blocksize;
+	struct ubi_fm_sb *sb = (struct ubi_fm_sb *)fm;
+	struct ubi_vid_hdr *vid;
+	unsigned int anchor = UBI_NO_PEB;
+	unsigned int sqnum = 0;
+	unsigned int used_blocks, crc;
+	unsigned int pnum, i;
+
+	/* the anchor with the highest sequence number is the current one */
+	for (pnum = 0; (pnum < UBI_FM_MAX_START) && (pnum < ubi->peb_count);
+	     pnum++) {
+		vid = ubi_read_vid_hdr(ubi, pnum);
+		if (!vid || (swap_uint32(vid->vol_id) != UBI_FM_SB_VOLUME_ID))
+			continue;
+
+		if ((anchor == UBI_NO_PEB)
+		    || (swap_uint32(vid->sqnum[1]) > sqnum)) {
+			anchor = pnum;
+			sqnum = swap_uint32(vid->sqnum[1]);
+		}
+	}
+
+	if (anchor == UBI_NO_PEB)
+		return -1;
+
+	if (ubi_read_leb(ubi, anchor, fm, ubi->leb_size))
+		return -1;
+
+	used_blocks = swap_uint32(sb->used_blocks);
+	if ((swap_uint32(sb->magic) != UBI_FM_SB_MAGIC)
+	    || (sb->version != UBI_FM_FMT_VERSION)
+	    || !used_blocks || (used_blocks > UBI_FM_MAX_BLOCKS)
+	    || (swap_uint32(sb->block_loc[0]) != anchor))
+		return -1;
+
+	for (i = 1; i < used_blocks; i++) {
+		pnum = swap_uint32(sb->block_loc[i]);
+		if (pnum >= ubi->peb_count)
+			return -1;
+
+		vid = ubi_read_vid_hdr(ubi, pnum);
+		if (!vid || (swap_uint32(vid->vol_id) != UBI_FM_DATA_VOLUME_ID))
+			return -1;
+
+		if (ubi_read_leb(ubi, pnum, fm + i * ubi->leb_size,
+				 ubi->leb_size))
+			return -1;
+	}
+
+	crc = swap_uint32(sb->data_crc);
+	sb->data_crc = 0;
+	if (ubi_crc(fm, used_blocks * ubi->leb_size) != crc) {
+		dbg_info("UBI: fastmap CRC error\n");
+		return -1;
+	}
+
+	return ubi_parse_fastmap(ubi, fm, used_blocks * ubi->leb_size);
+}
+
+static void ubi_attach_scan(struct ubi_device *ubi)
+{
+	struct ubi_vid_hdr *vid;
+	unsigned int pnum;
+
+	for (pnum = 0; pnum < ubi->peb_count; pnum++) {
+		vid = ubi_read_vid_hdr(ubi, pnum);
+		if (vid)
+			ubi_add_leb(ubi, vid, pnum);
+	}
+}
+
+static int ubi_load_volume(struct ubi_device *ubi,
+			   struct ubi_volume *vol,
+			   unsigned char *dest,
+			   unsigned int *length)
+{
+	unsigned int leb_size = ubi->leb_size - vol->data_pad;
+	unsigned int lnum, len;
+
+	if (!vol->used_ebs) {
+		dbg_info("UBI: static volume %d not found\n", vol->vol_id);
+		return -1;
+	}
+
+	if ((vol->used_ebs > CONFIG_UBI_MAX_LEBS)
+	    || (vol->data_pad >= ubi->leb_size)
+	    || (vol->last_eb_bytes > ubi->leb_size - vol->data_pad)) {
+		dbg_info("UBI: volume %d is too large\n", vol->vol_id);
+		return -1;
+	}
+
+	dbg_info("UBI: volume %d: Copy %d LEBs to %x\n",
+		 vol->vol_id, vol->used_ebs, dest);
+
+	*length = 0;
+	for (lnum = 0; lnum < vol->used_ebs; lnum++) {
+		if (vol->peb[lnum] == UBI_NO_PEB) {
+			dbg_info("UBI: volume %d: LEB %d is missing\n",
+				 vol->vol_id, lnum);
+			return -1;
+		}
+
+		if (lnum == vol->used_ebs - 1)
+			len = vol->last_eb_bytes;
+		else
+			len = leb_size;
+
+		if (ubi_read_leb(ubi, vol->peb[lnum], dest, len))
+			return -1;
+
+		uimage_crc_update(dest, len);
+
+		dest += len;
+		*length += len;
+	}
+
+	return 0;
+}
+
+int ubi_load_image(struct nand_info *nand, struct image_info *image)
+{
+	struct ubi_device ubi;
+	unsigned int size = CONFIG_UBI_SIZE;
+	int ret;
+
+	ubi.nand = nand;
+	ubi.first_block = div(CONFIG_UBI_OFFSET, nand->blocksize);
+	if (ubi.first_block >= nand->numblocks)
+		return -1;
+
+	ubi.peb_count = nand->numblocks - ubi.first_block;
+	if (size && (div(size, nand->blocksize) < ubi.peb_count))
+		ubi.peb_count = div(size, nand->blocksize);
+	if (ubi.peb_count > UBI_NO_PEB)
+		ubi.peb_count = UBI_NO_PEB;
+
+	ubi.buf = image->dest;
+	ubi.vols = ubi_vols;
+	ubi.vols[0].vol_id = CONFIG_UBI_KERNEL_VOLUME_ID;
+	ubi.nvols = 1;
+#ifdef CONFIG_OF_LIBFDT
+	if (image->of_dest) {
+		ubi.vols[1].vol_id = CONFIG_UBI_DT_VOLUME_ID;
+		ubi.nvols = 2;
+	}
+#endif
+
+	if (ubi_read_geometry(&ubi)) {
+		dbg_info("UBI: no UBI image at %x\n", CONFIG_UBI_OFFSET);
+		return -1;
+	}
+
+	ubi_init_volumes(&ubi);
+	if (ubi_attach_fastmap(&ubi)) {
+		dbg_info("UBI: no fastmap, scanning %d PEBs\n", ubi.peb_count);
+		ubi_init_volumes(&ubi);
+		ubi_attach_scan(&ubi);
+	} else {
+		dbg_info("UBI: attached from the fastmap\n");
+	}
+
+	ret = ubi_load_volume(&ubi, &ubi.vols[0], image->dest, &image->length);
+	if (ret)
+		return ret;
+
+#ifdef CONFIG_OF_LIBFDT
+	if (image->of_dest)
+		ret = ubi_load_volume(&ubi, &ubi.vols[1], image->of_dest,
+				      &image->of_length);
+#endif
+
+	return ret;
+}
@@ -0,0 +1,132 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+#include "common.h"
+#include "hardware.h"
+#include "string.h"
+#include "pmc.h"
+#include "rstc.h"
+#include "crc32.h"
+#include "fdt.h"
+#include "debug.h"
+#include "warm_boot.h"
+#include "arch/at91_rstc.h"
+
+#define WARM_BOOT_MAGIC		0x5741524d	/* "WARM" */
+
+/*
+ * Where and what the previous boot handed over to Linux, kept in the
+ * secure RAM after the PM data Linux stores at its start. The dtb is
+ * recorded once fixed up, as it is left in memory.
+ *
+ * Nothing ties the record to the images on the boot media: an OS that
+ * updates them zeroes the magic, the first word, so that the next
+ * reset loads them again.
+ */
+struct warm_boot_record {
+	unsigned int	magic;
+	unsigned int	kernel_addr;
+	unsigned int	kernel_len;
+	unsigned int	kernel_crc;
+	unsigned int	dt_addr;
+	unsigned int	dt_len;
+	unsigned int	dt_crc;
+	unsigned int	crc;		/* of the fields above */
+};
+
+static struct warm_boot_record *warm_boot_record(void)
+{
+#ifdef AT91C_ID_SECURAM
+	pmc_enable_periph_clock(AT91C_ID_SECURAM, PMC_PERIPH_CLK_DIVIDER_NA);
+#endif
+
+	return (struct warm_boot_record *)(AT91C_BASE_SECURAM
+					   + CONFIG_WARM_BOOT_SECURAM_OFFSET);
+}
+
+static unsigned int warm_boot_record_crc(struct warm_boot_record *record)
+{
+	return crc32(0, (const unsigned char *)record,
+		     sizeof(*record) - sizeof(record->crc));
+}
+
+/*
+ * Return 0 when the reset kept the RAM and both images recorded by the
+ * previous boot are still there, intact: they need not be loaded again.
+ */
+int warm_boot_check(struct image_info *image)
+{
+	struct warm_boot_record record;
+	unsigned int type = rstc_get_reset_type();
+	int len;
+
+	if ((type != AT91C_RSTC_RSTTYP_WATCHDOG)
+	    && (type != AT91C_RSTC_RSTTYP_SOFTWARE))
+		return -1;
+
+	memcpy(&record, warm_boot_record(), sizeof(record));
+
+	if ((record.magic != WARM_BOOT_MAGIC)
+	    || (record.crc != warm_boot_record_crc(&record)))
+		return -1;
+
+	if ((record.kernel_addr != (unsigned int)image->dest)
+	    || (record.dt_addr != (unsigned int)image->of_dest))
+		return -1;
+
+	/* the headers first, so that a reused area is told cheaply */
+	len = kernel_size(image->dest);
+	if ((len <= 0) || ((unsigned int)len != record.kernel_len))
+		return -1;
+
+	if (check_dt_blob_valid(image->of_dest)
+	    || (of_get_dt_total_size(image->of_dest) != record.dt_len))
+		return -1;
+
+	if ((crc32(0, image->of_dest, record.dt_len) != record.dt_crc)
+	    || (crc32(0, image->dest, record.kernel_len) != record.kernel_crc)) {
+		dbg_info("WARM: the images in RAM changed, loading them\n");
+		return -1;
+	}
+
+	dbg_info("WARM: kernel at %x and dt blob at %x still valid\n",
+		 image->dest, image->of_dest);
+
+	return 0;
+}
+
+static struct warm_boot_record next;
+
+/*
+ * Called right after the load, before a uImage is relocated: if the
+ * relocation overwrites the image, the next check fails instead of
+ * relocating a clobbered copy.
+ */
+void warm_boot_prepare(struct image_info *image)
+{
+	int len = kernel_size(image->dest);
+
+	memset(&next, 0, sizeof(next));
+
+	if (len <= 0)
+		return;
+
+	next.kernel_addr = (unsigned int)image->dest;
+	next.kernel_len = len;
+	next.kernel_crc = crc32(0, image->dest, len);
+}
+
+/* Called once the dtb is fixed up, right before starting the kernel */
+void warm_boot_save(struct image_info *image)
+{
+	if (next.kernel_len && !check_dt_blob_valid(image->of_dest)) {
+		next.magic = WARM_BOOT_MAGIC;
+		next.dt_addr = (unsigned int)image->of_dest;
+		next.dt_len = of_get_dt_total_size(image->of_dest);
+		next.dt_crc = crc32(0, image->of_dest, next.dt_len);
+		next.crc = warm_boot_record_crc(&next);
+	}
+
+	memcpy(warm_boot_record(), &next, sizeof(next));
+}
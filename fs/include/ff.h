@@ -199,6 +199,17 @@ typedef enum {
 
 
 
+/* Batch lookup entry structure (FLOOKUP) */
+
+typedef struct {
+	const TCHAR*	name;		/* Name of the object in the root directory (in) */
+	FRESULT	res;			/* FR_OK when found (out) */
+	DWORD	sclust;			/* File start cluster (out) */
+	DWORD	fsize;			/* File size (out) */
+} FLOOKUP;
+
+
+
 /*--------------------------------------------------------------*/
 /* FatFs module application interface                           */
 
@@ -223,6 +234,9 @@ FRESULT f_chdrive (BYTE);						/* Change current drive */
 FRESULT f_chdir (const TCHAR*);						/* Change current directory */
 FRESULT f_getcwd (TCHAR*, UINT);					/* Get current directory */
 FRESULT f_forward (FIL*, UINT(*)(const BYTE*,UINT), UINT, UINT*);	/* Forward data to the stream */
+FRESULT f_lookup (FLOOKUP*, UINT);				/* Resolve several files in one directory scan */
+FRESULT f_open_lookup (FIL*, const FLOOKUP*);			/* Open a file resolved by f_lookup */
+FRESULT f_stream (FIL*, BYTE*, UINT, UINT(*)(const BYTE*,UINT,void*), void*, UINT*);	/* Read a file into a window through a consumer */
 FRESULT f_mkfs (BYTE, BYTE, UINT);					/* Create a file system on the drive */
 FRESULT	f_fdisk (BYTE, const DWORD[], void*);				/* Divide a physical drive into some partitions */
 int f_putc (TCHAR, FIL*);						/* Put a character to the file */
@@ -48,6 +48,16 @@
 /* To enable f_forward function, set _USE_FORWARD to 1 and set _FS_TINY to 1. */
 
 
+#define	_USE_LOOKUP	1	/* 0:Disable or 1:Enable */
+#define	_MAX_LOOKUP	4	/* Maximum number of names resolved by one f_lookup call */
+/* To enable f_lookup and f_open_lookup functions, set _USE_LOOKUP to 1. */
+
+
+#define	_USE_STREAM	1	/* 0:Disable or 1:Enable */
+#define	_STREAM_SECTORS	128	/* Maximum number of sectors per read of f_stream (1..255) */
+/* To enable f_stream function, set _USE_STREAM to 1. */
+
+
 #define	_USE_FASTSEEK	0	/* 0:Disable or 1:Enable */
 /* To enable fast seek feature, set _USE_FASTSEEK to 1. */
 
@@ -2364,6 +2364,157 @@ FRESULT f_open (
 
 
 
+#if _USE_LOOKUP
+/*-----------------------------------------------------------------------*/
+/* Resolve a list of files in a single scan of the root directory        */
+/*-----------------------------------------------------------------------*/
+
+static struct {
+	BYTE	sfn[12];		/* SFN of the name {file[8],ext[3],status[1]} */
+#if _USE_LFN
+	WCHAR	lfn[_MAX_LFN + 1];	/* LFN of the name */
+	BYTE	ord, sum;		/* LFN sequence being matched */
+#endif
+	BYTE	done;			/* Name resolved or rejected */
+} LookupBuf[_MAX_LOOKUP];
+
+FRESULT f_lookup (
+	FLOOKUP *list,		/* Pointer to the names to be resolved */
+	UINT count		/* Number of names in the list */
+)
+{
+	FRESULT res;
+	DIR dj;
+	BYTE c, *dir;
+	const TCHAR *path;
+	UINT i, pending;
+#if _USE_LFN
+	BYTE a, ord;
+#endif
+
+
+	if (!count || count > _MAX_LOOKUP) return FR_INVALID_PARAMETER;
+
+	path = list[0].name;
+	res = chk_mounted(&path, &dj.fs, 0);
+	if (res != FR_OK) LEAVE_FF(dj.fs, res);
+
+	/* Convert all the names to directory form, only root objects are handled */
+	for (i = pending = 0; i < count; i++) {
+		path = list[i].name;
+		if (*path == '/' || *path == '\\') path++;
+		dj.fn = LookupBuf[i].sfn;
+#if _USE_LFN
+		dj.lfn = LookupBuf[i].lfn;
+		LookupBuf[i].ord = LookupBuf[i].sum = 0xFF;
+#endif
+		list[i].sclust = list[i].fsize = 0;
+		LookupBuf[i].done = 1;
+		list[i].res = create_name(&dj, &path);
+		if (list[i].res != FR_OK) continue;
+		if (!(LookupBuf[i].sfn[NS] & NS_LAST)) {	/* Not in the root directory */
+			list[i].res = FR_NO_PATH;
+			continue;
+		}
+		list[i].res = FR_NO_FILE;
+		LookupBuf[i].done = 0;
+		pending++;
+	}
+
+	dj.sclust = 0;
+	res = dir_sdi(&dj, 0);			/* Rewind the root directory */
+	while (res == FR_OK && pending) {
+		res = move_window(dj.fs, dj.sect);
+		if (res != FR_OK) break;
+		dir = dj.dir;				/* Ptr to the directory entry of current index */
+		c = dir[DIR_Name];
+		if (c == 0) break;			/* Reached to end of table */
+#if _USE_LFN	/* LFN configuration */
+		a = dir[DIR_Attr] & AM_MASK;
+		for (i = 0; i < count; i++) {
+			if (LookupBuf[i].done) continue;
+			if (c == DDE || ((a & AM_VOL) && a != AM_LFN)) {	/* An entry without valid data */
+				LookupBuf[i].ord = 0xFF;
+			} else if (a == AM_LFN) {		/* An LFN entry is found */
+				ord = c;
+				if (ord & LLE) {		/* Is it start of LFN sequence? */
+					LookupBuf[i].sum = dir[LDIR_Chksum];
+					ord &= ~LLE; LookupBuf[i].ord = ord;
+				}
+				/* Check validity of the LFN entry and compare it with the name */
+				LookupBuf[i].ord = (ord == LookupBuf[i].ord && LookupBuf[i].sum == dir[LDIR_Chksum]
+						&& cmp_lfn(LookupBuf[i].lfn, dir)) ? ord - 1 : 0xFF;
+			} else {				/* An SFN entry is found */
+				if ((!LookupBuf[i].ord && LookupBuf[i].sum == sum_sfn(dir))	/* LFN matched? */
+					|| (!(LookupBuf[i].sfn[NS] & NS_LOSS) && !mem_cmp(dir, LookupBuf[i].sfn, 11))) {	/* SFN matched? */
+					list[i].res = (dir[DIR_Attr] & AM_DIR) ? FR_NO_FILE : FR_OK;
+					list[i].sclust = LD_CLUST(dir);
+					list[i].fsize = LD_DWORD(dir+DIR_FileSize);
+					LookupBuf[i].done = 1;
+					pending--;
+				}
+				LookupBuf[i].ord = 0xFF;
+			}
+		}
+#else		/* Non LFN configuration */
+		if (!(dir[DIR_Attr] & AM_VOL)) {	/* Is it a valid entry? */
+			for (i = 0; i < count; i++) {
+				if (LookupBuf[i].done || mem_cmp(dir, LookupBuf[i].sfn, 11)) continue;
+				list[i].res = (dir[DIR_Attr] & AM_DIR) ? FR_NO_FILE : FR_OK;
+				LookupBuf[i].done = 1;
+				list[i].sclust = LD_CLUST(dir);
+				list[i].fsize = LD_DWORD(dir+DIR_FileSize);
+				pending--;
+			}
+		}
+#endif
+		res = dir_next(&dj, 0);			/* Next entry */
+	}
+	if (res == FR_NO_FILE) res = FR_OK;		/* End of the directory */
+
+	LEAVE_FF(dj.fs, res);
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Open a file resolved by f_lookup                                      */
+/*-----------------------------------------------------------------------*/
+
+FRESULT f_open_lookup (
+	FIL *fp,		/* Pointer to the blank file object */
+	const FLOOKUP *entry	/* Pointer to the resolved entry */
+)
+{
+	FRESULT res;
+	FATFS *fs;
+	const TCHAR *path = entry->name;
+
+
+	fp->fs = 0;		/* Clear file object */
+	if (entry->res != FR_OK) return entry->res;
+
+	res = chk_mounted(&path, &fs, 0);
+	if (res == FR_OK) {
+		fp->flag = FA_READ;			/* File access mode */
+		fp->sclust = entry->sclust;		/* File start cluster */
+		fp->fsize = entry->fsize;		/* File size */
+		fp->fptr = 0;				/* File pointer */
+		fp->dsect = 0;
+#if _USE_FASTSEEK
+		fp->cltbl = 0;				/* Normal seek mode */
+#endif
+		fp->fs = fs; fp->id = fs->id;		/* Validate file object */
+	}
+
+	LEAVE_FF(fs, res);
+}
+#endif /* _USE_LOOKUP */
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Read File                                                             */
 /*-----------------------------------------------------------------------*/
@@ -2464,6 +2615,95 @@ FRESULT f_read (
 
 
 
+#if _USE_STREAM
+/*-----------------------------------------------------------------------*/
+/* Stream File Data into a Window                                        */
+/*-----------------------------------------------------------------------*/
+/* The rest of the file is read into buff, which holds max bytes at most.
+/  Runs of consecutive clusters are read as one extent, by requests of up
+/  to _STREAM_SECTORS sectors, and each piece is passed to func as soon
+/  as it is in memory. A file which does not fit is rejected before any
+/  read. func returns 0 to stop the transfer. */
+
+FRESULT f_stream (
+	FIL *fp,				/* Pointer to the file object */
+	BYTE *buff,				/* Pointer to the destination window */
+	UINT max,				/* Size of the destination window */
+	UINT (*func)(const BYTE*,UINT,void*),	/* Consumer of the data read */
+	void *arg,				/* Argument passed to func */
+	UINT *br				/* Pointer to number of bytes read */
+)
+{
+	FRESULT res;
+	DWORD clst, sect, remain;
+	UINT btr, rcnt, cc, want;
+	BYTE csect;
+
+
+	*br = 0;	/* Initialize byte counter */
+
+	res = validate(fp->fs, fp->id);			/* Check validity */
+	if (res != FR_OK) LEAVE_FF(fp->fs, res);
+	if (fp->flag & FA__ERROR)			/* Aborted file? */
+		LEAVE_FF(fp->fs, FR_INT_ERR);
+	if (!(fp->flag & FA_READ)) 			/* Check access mode */
+		LEAVE_FF(fp->fs, FR_DENIED);
+	remain = fp->fsize - fp->fptr;
+	if (remain > max)				/* Does not fit in the window */
+		LEAVE_FF(fp->fs, FR_DENIED);
+	btr = (UINT)remain;
+
+	for ( ;  btr;					/* Repeat until all data read */
+		buff += rcnt, *br += rcnt, btr -= rcnt) {
+		if ((fp->fptr % SS(fp->fs)) || btr < SS(fp->fs)) {
+			/* Partial sector, through the sector buffer */
+			rcnt = SS(fp->fs) - (fp->fptr % SS(fp->fs));
+			if (rcnt > btr) rcnt = btr;
+			res = f_read(fp, buff, rcnt, &cc);
+			if (res != FR_OK) return res;
+			if (cc != rcnt) LEAVE_FF(fp->fs, FR_INT_ERR);
+		} else {
+			csect = (BYTE)(fp->fptr / SS(fp->fs) & (fp->fs->csize - 1));	/* Sector offset in the cluster */
+			if (!csect) {				/* On the cluster boundary? */
+				clst = (fp->fptr == 0) ?	/* On the top of the file? */
+					fp->sclust : get_fat(fp->fs, fp->clust);
+				if (clst < 2) ABORT(fp->fs, FR_INT_ERR);
+				if (clst == 0xFFFFFFFF) ABORT(fp->fs, FR_DISK_ERR);
+				fp->clust = clst;		/* Update current cluster */
+			}
+			sect = clust2sect(fp->fs, fp->clust);	/* Get current sector */
+			if (!sect) ABORT(fp->fs, FR_INT_ERR);
+			sect += csect;
+
+			want = btr / SS(fp->fs);		/* Whole sectors left */
+			if (want > _STREAM_SECTORS) want = _STREAM_SECTORS;
+			cc = fp->fs->csize - csect;		/* Sectors left in the cluster */
+			while (cc < want) {			/* Extend over the next cluster if it follows */
+				clst = get_fat(fp->fs, fp->clust);
+				if (clst == 0xFFFFFFFF) ABORT(fp->fs, FR_DISK_ERR);
+				if (clst != fp->clust + 1) break;
+				fp->clust = clst;
+				cc += fp->fs->csize;
+			}
+			if (cc > want) cc = want;
+
+			if (disk_read(fp->fs->drv, buff, sect, (BYTE)cc) != RES_OK)
+				ABORT(fp->fs, FR_DISK_ERR);
+			rcnt = SS(fp->fs) * cc;			/* Number of bytes transferred */
+			fp->fptr += rcnt;
+		}
+
+		if ((*func)(buff, rcnt, arg) != rcnt)	/* Hand the data to the consumer */
+			LEAVE_FF(fp->fs, FR_INT_ERR);
+	}
+
+	LEAVE_FF(fp->fs, FR_OK);
+}
+#endif /* _USE_STREAM */
+
+
+
+
 #if !_FS_READONLY
 /*-----------------------------------------------------------------------*/
 /* Write File                                                            */
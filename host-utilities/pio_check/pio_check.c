@@ -0,0 +1,440 @@
+// Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+//
+// SPDX-License-Identifier: MIT
+
+/*
+ * Host check of the batched pio_configure(): random pin tables are applied
+ * to a model of the PIO registers, once through driver/at91_pio.c and once
+ * through the former pin by pin sequence kept below, and the final register
+ * values are compared for every pin.
+ *
+ * The former PIO3 peripheral C/D paths tested "config && PIO_PULLUP" and
+ * enabled the pull-up for any non-zero attribute. The reference is run both
+ * with that test and with "config & PIO_PULLUP": the first run may only
+ * differ on the pull-up of those C/D pins, the second one must not differ.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../driver/at91_pio.c"
+
+#define ROUNDS		20000
+#define MAX_PINS	48
+
+struct pio_model {
+	unsigned int	psr;		/* PIO enabled */
+	unsigned int	osr;		/* output enabled */
+	unsigned int	ifsr;		/* input filter */
+	unsigned int	imr;		/* interrupt mask */
+	unsigned int	mdsr;		/* multi-driver */
+	unsigned int	pusr;		/* pull-up enabled */
+	unsigned int	pdsr;		/* pull-down enabled */
+	unsigned int	odsr;		/* output data */
+	unsigned int	absr;		/* peripheral B, PIO2 */
+	unsigned int	sp1;
+	unsigned int	sp2;
+	unsigned int	slewr;
+	unsigned int	driver1;
+	unsigned int	mskr;
+	unsigned int	cfgr[PIO_NUM_IO];
+};
+
+static struct pio_model model[AT91C_NUM_PIO];
+static unsigned int accesses;
+
+static struct pio_model *model_lookup(unsigned int addr, unsigned int *offset)
+{
+	unsigned int pio = (addr >> 12) - 1;
+
+	if (pio >= AT91C_NUM_PIO) {
+		fprintf(stderr, "access out of the PIO controllers: %x\n", addr);
+		exit(1);
+	}
+
+	*offset = addr & 0xfff;
+	accesses++;
+
+	return &model[pio];
+}
+
+static void bad_access(const char *what, unsigned int offset)
+{
+	fprintf(stderr, "%s of a register not in the model: %x\n",
+		what, offset);
+	exit(1);
+}
+
+void writel(unsigned int value, unsigned int addr)
+{
+	unsigned int offset;
+	struct pio_model *m = model_lookup(addr, &offset);
+#ifdef CONFIG_CPU_HAS_PIO4
+	unsigned int i;
+
+	switch (offset) {
+	case PIO_MSKR:
+		m->mskr = value;
+		break;
+	case PIO_CFGR:
+		for (i = 0; i < PIO_NUM_IO; i++)
+			if (m->mskr & (1U << i))
+				m->cfgr[i] = value;
+		break;
+	case PIO_SODR:
+		m->odsr |= value;
+		break;
+	case PIO_CODR:
+		m->odsr &= ~value;
+		break;
+	case PIO_IDR:
+		m->imr &= ~value;
+		break;
+	default:
+		bad_access("write", offset);
+	}
+#else
+	switch (offset) {
+	case PIO_PER:
+		m->psr |= value;
+		break;
+	case PIO_PDR:
+		m->psr &= ~value;
+		break;
+	case PIO_OER:
+		m->osr |= value;
+		break;
+	case PIO_ODR:
+		m->osr &= ~value;
+		break;
+	case PIO_IFER:
+		m->ifsr |= value;
+		break;
+	case PIO_IFDR:
+		m->ifsr &= ~value;
+		break;
+	case PIO_SODR:
+		m->odsr |= value;
+		break;
+	case PIO_CODR:
+		m->odsr &= ~value;
+		break;
+	case PIO_IDR:
+		m->imr &= ~value;
+		break;
+	case PIO_MDER:
+		m->mdsr |= value;
+		break;
+	case PIO_MDDR:
+		m->mdsr &= ~value;
+		break;
+	case PIO_PPUER:
+		m->pusr |= value;
+		break;
+	case PIO_PPUDR:
+		m->pusr &= ~value;
+		break;
+#ifdef CONFIG_CPU_HAS_PIO3
+	case PIO_SP1:
+		m->sp1 = value;
+		break;
+	case PIO_SP2:
+		m->sp2 = value;
+		break;
+	case PIO_PPDER:
+		m->pdsr |= value;
+		break;
+	case PIO_PPDDR:
+		m->pdsr &= ~value;
+		break;
+	case PIO_SLEWR:
+		m->slewr = value;
+		break;
+	case PIO_DRIVER1:
+		m->driver1 = value;
+		break;
+#else
+	case PIO_ASR:
+		m->absr &= ~value;
+		break;
+	case PIO_BSR:
+		m->absr |= value;
+		break;
+#endif
+	default:
+		bad_access("write", offset);
+	}
+#endif
+}
+
+unsigned int readl(unsigned int addr)
+{
+	unsigned int offset;
+	struct pio_model *m = model_lookup(addr, &offset);
+
+	(void)m;
+
+	switch (offset) {
+#if defined(CONFIG_CPU_HAS_PIO3)
+	case PIO_SP1:
+		return m->sp1;
+	case PIO_SP2:
+		return m->sp2;
+	case PIO_SLEWR:
+		return m->slewr;
+	case PIO_DRIVER1:
+		return m->driver1;
+#elif !defined(CONFIG_CPU_HAS_PIO4)
+	case PIO_ABSR:
+		return m->absr;
+#endif
+	default:
+		bad_access("read", offset);
+	}
+
+	return 0;
+}
+
+/*
+ * The pin by pin sequence pio_configure() used before the batching,
+ * except for the C/D pull-up test selected by ref_literal_cd_pullup.
+ */
+static int ref_literal_cd_pullup;
+
+#ifdef CONFIG_CPU_HAS_PIO3
+static int ref_cd_pullup(int config)
+{
+	return ref_literal_cd_pullup ? (config && PIO_PULLUP)
+				     : (config & PIO_PULLUP);
+}
+#endif
+
+#ifdef CONFIG_CPU_HAS_PIO4
+static void ref_pio4_set_periph(unsigned pio, unsigned mask,
+				int config, unsigned func)
+{
+	write_pio(pio, PIO_MSKR, mask);
+	write_pio(pio, PIO_CFGR, pio4_cfgr(config, func));
+}
+#endif
+
+static int ref_set_periph(unsigned pin, enum pio_type type, int config)
+{
+	unsigned pio = pin_to_controller(pin);
+	unsigned mask = pin_to_mask(pin);
+
+	if (pio >= AT91C_NUM_PIO)
+		return -1;
+
+	if (config & PIO_PULLUP && config & PIO_PULLDOWN)
+		return -1;
+
+#ifdef CONFIG_CPU_HAS_PIO4
+	ref_pio4_set_periph(pio, mask, config,
+			    AT91C_PIO_CFGR_FUNC_PERIPH_A + type);
+#elif defined(CONFIG_CPU_HAS_PIO3)
+	if (type > PIO_PERIPH_D)
+		return 0;
+
+	write_pio(pio, PIO_IDR, mask);
+	if (type == PIO_PERIPH_C || type == PIO_PERIPH_D)
+		write_pio(pio, (ref_cd_pullup(config) ? PIO_PPUER : PIO_PPUDR),
+			  mask);
+	else
+		write_pio(pio, ((config & PIO_PULLUP) ? PIO_PPUER : PIO_PPUDR),
+			  mask);
+	write_pio(pio, ((config & PIO_PULLDOWN) ? PIO_PPDER : PIO_PPDDR), mask);
+
+	pio3_set_drvstr(pin, config);
+	pio3_set_slewrate(pin, config);
+
+	if (type == PIO_PERIPH_B || type == PIO_PERIPH_D)
+		write_pio(pio, PIO_SP1, read_pio(pio, PIO_SP1) | mask);
+	else
+		write_pio(pio, PIO_SP1, read_pio(pio, PIO_SP1) & ~mask);
+	if (type == PIO_PERIPH_C || type == PIO_PERIPH_D)
+		write_pio(pio, PIO_SP2, read_pio(pio, PIO_SP2) | mask);
+	else
+		write_pio(pio, PIO_SP2, read_pio(pio, PIO_SP2) & ~mask);
+	write_pio(pio, PIO_PDR, mask);
+#else
+	if (type > PIO_PERIPH_B)
+		return 0;
+
+	write_pio(pio, PIO_IDR, mask);
+	write_pio(pio, ((config & PIO_PULLUP) ? PIO_PPUER : PIO_PPUDR), mask);
+	write_pio(pio, (type == PIO_PERIPH_B) ? PIO_BSR : PIO_ASR, mask);
+	write_pio(pio, PIO_PDR, mask);
+#endif
+
+	return 0;
+}
+
+static int ref_pio_configure(const struct pio_desc *pio_desc)
+{
+	unsigned pio, pin = 0;
+
+	while (pio_desc->pin_name) {
+		pio = pin_to_controller(pio_desc->pin_num);
+		if (pio >= AT91C_NUM_PIO)
+			return 0;
+		else if (pio_desc->type <= PIO_PERIPH_G)
+			ref_set_periph(pio_desc->pin_num, pio_desc->type,
+				       pio_desc->attribute);
+		else if (pio_desc->type == PIO_INPUT)
+			pio_set_gpio_input(pio_desc->pin_num,
+					   pio_desc->attribute);
+		else if (pio_desc->type == PIO_OUTPUT)
+			pio_config_gpio_output(pio_desc->pin_num,
+					       pio_desc->attribute,
+					       pio_desc->default_value);
+		else
+			return 0;
+
+		++pin;
+		++pio_desc;
+	}
+
+	return pin;
+}
+
+static void random_model(void)
+{
+	unsigned char *p = (unsigned char *)model;
+	unsigned int i;
+
+	for (i = 0; i < sizeof(model); i++)
+		p[i] = rand();
+}
+
+/*
+ * Mostly peripheral pins, on few controllers and pins so that the same
+ * pin comes back while still pending, with any attribute combination.
+ */
+static void random_table(struct pio_desc *table, unsigned int count)
+{
+	unsigned int i, kind;
+
+	for (i = 0; i < count; i++) {
+		table[i].pin_name = "PIN";
+		table[i].pin_num = (rand() % 3) * PIO_NUM_IO + (rand() % 8);
+		table[i].default_value = rand() & 1;
+		table[i].attribute = rand();
+
+		kind = rand() % 10;
+		if (kind < 7)
+			table[i].type = (enum pio_type)(rand() % 7);
+		else if (kind < 8)
+			table[i].type = PIO_INPUT;
+		else
+			table[i].type = PIO_OUTPUT;
+	}
+
+	/* sometimes end on a pin out of the controllers */
+	if (count && !(rand() % 16))
+		table[count - 1].pin_num = AT91C_NUM_PIO * PIO_NUM_IO;
+
+	table[count].pin_name = NULL;
+}
+
+/* Pull-ups the literal C/D test enables and the batched code does not */
+static void cd_pullup_mask(const struct pio_desc *table, unsigned int *mask)
+{
+	unsigned int pio, bit;
+
+	memset(mask, 0, AT91C_NUM_PIO * sizeof(*mask));
+
+	for (; table->pin_name; table++) {
+		pio = pin_to_controller(table->pin_num);
+		if (pio >= AT91C_NUM_PIO)
+			break;
+
+		/* entries which leave the pull-up alone */
+		if ((table->type > PIO_PERIPH_D) && (table->type <= PIO_PERIPH_G))
+			continue;
+		if ((table->type != PIO_OUTPUT)
+		    && (table->attribute & PIO_PULLUP)
+		    && (table->attribute & PIO_PULLDOWN))
+			continue;
+
+		bit = pin_to_mask(table->pin_num);
+		mask[pio] &= ~bit;
+		if ((table->type == PIO_PERIPH_C || table->type == PIO_PERIPH_D)
+		    && table->attribute && !(table->attribute & PIO_PULLUP))
+			mask[pio] |= bit;
+	}
+}
+
+static int compare(const struct pio_model *ref, const struct pio_model *new,
+		   const unsigned int *pullup_skip)
+{
+	unsigned int pio;
+	struct pio_model a, b;
+
+	for (pio = 0; pio < AT91C_NUM_PIO; pio++) {
+		a = ref[pio];
+		b = new[pio];
+
+		/* the scratch mask register is not part of the pin state */
+		a.mskr = b.mskr = 0;
+
+		if (pullup_skip) {
+			if ((a.pusr ^ b.pusr) & ~pullup_skip[pio])
+				return -1;
+			a.pusr = b.pusr = 0;
+		}
+
+		if (memcmp(&a, &b, sizeof(a)))
+			return -1;
+	}
+
+	return 0;
+}
+
+int main(void)
+{
+	static struct pio_desc table[MAX_PINS + 1];
+	struct pio_model start[AT91C_NUM_PIO], ref[AT91C_NUM_PIO];
+	unsigned int skip[AT91C_NUM_PIO];
+	unsigned int round, count, literal;
+	unsigned long ref_accesses = 0, new_accesses = 0;
+	int ref_ret, new_ret;
+
+	srand(1);
+
+	for (round = 0; round < ROUNDS; round++) {
+		count = rand() % (MAX_PINS + 1);
+		random_table(table, count);
+		random_model();
+		memcpy(start, model, sizeof(start));
+
+		for (literal = 0; literal < 2; literal++) {
+			ref_literal_cd_pullup = literal;
+
+			memcpy(model, start, sizeof(model));
+			accesses = 0;
+			ref_ret = ref_pio_configure(table);
+			memcpy(ref, model, sizeof(ref));
+			ref_accesses += literal ? 0 : accesses;
+
+			memcpy(model, start, sizeof(model));
+			accesses = 0;
+			new_ret = pio_configure(table);
+			new_accesses += literal ? 0 : accesses;
+
+			cd_pullup_mask(table, skip);
+			if ((ref_ret != new_ret)
+			    || compare(ref, model, literal ? skip : NULL)) {
+				fprintf(stderr, "round %u: %s reference differs\n",
+					round, literal ? "literal" : "fixed");
+				return 1;
+			}
+		}
+	}
+
+	printf("%u tables, %lu register accesses pin by pin, %lu batched\n",
+	       ROUNDS, ref_accesses, new_accesses);
+
+	return 0;
+}
@@ -0,0 +1,10 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __DEBUG_H__
+#define __DEBUG_H__
+
+#endif /* #ifndef __DEBUG_H__ */
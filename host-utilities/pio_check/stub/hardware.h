@@ -0,0 +1,22 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __HARDWARE_H__
+#define __HARDWARE_H__
+
+/* Five controllers, the accesses go to the register model of pio_check.c */
+#define AT91C_NUM_PIO		5
+
+#define AT91C_BASE_PIOA		0x1000
+#define AT91C_BASE_PIOB		0x2000
+#define AT91C_BASE_PIOC		0x3000
+#define AT91C_BASE_PIOD		0x4000
+#define AT91C_BASE_PIOE		0x5000
+
+extern void writel(unsigned int value, unsigned int addr);
+extern unsigned int readl(unsigned int addr);
+
+#endif /* #ifndef __HARDWARE_H__ */
@@ -0,0 +1,17 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __STRING_H__
+#define __STRING_H__
+
+/* Shadows include/string.h, the host C library provides these */
+#include <stddef.h>
+
+extern void *memset(void *dst, int val, size_t count);
+extern void *memcpy(void *dst, const void *src, size_t count);
+extern int memcmp(const void *a, const void *b, size_t count);
+
+#endif /* #ifndef __STRING_H__ */
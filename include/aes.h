@@ -56,6 +56,23 @@ typedef struct at91_aes_params {
 } at91_aes_params_t;
 
 
+/*
+ * Keyed context: the state of the engine and the CMAC subkey, kept
+ * between the operations of a boot so that they are not set up again.
+ */
+typedef struct at91_aes_ctx {
+	at91_aes_key_size_t	key_size;
+
+	/* mode and key currently programmed, 0/NULL if none */
+	unsigned int		mr;
+	const unsigned int	*key;
+
+	/* CMAC subkey K1, derived from cmac_key */
+	const unsigned int	*cmac_key;
+	unsigned int		subkey[AT91_AES_BLOCK_SIZE_WORD];
+} at91_aes_ctx_t;
+
+
 static inline unsigned int at91_aes_roundup(unsigned int data_length)
 {
 	unsigned int fixed_length;
@@ -68,21 +85,21 @@ static inline unsigned int at91_aes_roundup(unsigned int data_length)
 }
 
 
-void at91_aes_init(void);
-void at91_aes_cleanup(void);
+void at91_aes_init(at91_aes_ctx_t *ctx, at91_aes_key_size_t key_size);
+void at91_aes_cleanup(at91_aes_ctx_t *ctx);
 
-int at91_aes_cbc(unsigned int data_length,
+int at91_aes_cbc(at91_aes_ctx_t *ctx,
+		 unsigned int data_length,
 		 const void *input,
 		 void *output,
 		 int encrypt,
-		 at91_aes_key_size_t key_size,
 		 const unsigned int *key,
 		 const unsigned int *iv);
 
-int at91_aes_cmac(unsigned int data_length,
+int at91_aes_cmac(at91_aes_ctx_t *ctx,
+		  unsigned int data_length,
 		  const void *data,
 		  unsigned int *cmac,
-		  at91_aes_key_size_t key_size,
 		  const unsigned int *key);
 
 #endif /* __AES_H__ */
@@ -98,10 +98,14 @@
 
 #define QSPI_PCALCFG_CALP		(0xf << 24)
 #define QSPI_PCALCFG_CALN		(0xf << 28)
+#define QSPI_PCALCFG_GET_CALP(v)	(((v) & QSPI_PCALCFG_CALP) >> 24)
+#define QSPI_PCALCFG_GET_CALN(v)	(((v) & QSPI_PCALCFG_CALN) >> 28)
 
 #define QSPI_PCALBP_BPEN		(0x1 << 0)
 #define QSPI_PCALBP_CALPBP		(0xf << 8)
 #define QSPI_PCALBP_CALNBP		(0xf << 16)
+#define QSPI_PCALBP_CALPBP_VAL(x)	(((x) << 8) & QSPI_PCALBP_CALPBP)
+#define QSPI_PCALBP_CALNBP_VAL(x)	(((x) << 16) & QSPI_PCALBP_CALNBP)
 
 #define QSPI_TOUT_TCNTM			0xffff
 
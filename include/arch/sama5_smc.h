@@ -80,4 +80,42 @@
 #define 	AT91C_SMC_MODE_TDF_MODE_DISABLED		(0x00 << 20)
 #define 	AT91C_SMC_MODE_TDF_MODE_ENABLED		(0x01 << 20)
 
+/**** NFC registers, at the start of the HSMC ***/
+#define HSMC_NFC_CFG	0x00	/* NFC Configuration Register */
+#define HSMC_NFC_CTRL	0x04	/* NFC Control Register */
+#define HSMC_NFC_SR	0x08	/* NFC Status Register */
+#define HSMC_NFC_ADDR	0x18	/* NFC Address Cycle Zero Register */
+#define HSMC_NFC_BANK	0x1C	/* NFC Bank Register */
+
+#define AT91C_NFC_CFG_PAGESIZE(x)	((x) & 0x7)
+#define AT91C_NFC_CFG_WSPARE		(0x01 << 8)
+#define AT91C_NFC_CFG_RSPARE		(0x01 << 9)
+#define AT91C_NFC_CFG_DTOCYC(x)		(((x) & 0xf) << 16)
+#define AT91C_NFC_CFG_DTOMUL(x)		(((x) & 0x7) << 20)
+#define AT91C_NFC_CFG_SPARESIZE(x)	(((x) & 0x7f) << 24)
+
+#define AT91C_NFC_CTRL_NFCEN		(0x01 << 0)
+#define AT91C_NFC_CTRL_NFCDIS		(0x01 << 1)
+
+#define AT91C_NFC_SR_XFRDONE		(0x01 << 16)
+#define AT91C_NFC_SR_CMDDONE		(0x01 << 17)
+#define AT91C_NFC_SR_DTOE		(0x01 << 20)
+#define AT91C_NFC_SR_UNDEF		(0x01 << 21)
+#define AT91C_NFC_SR_AWB		(0x01 << 22)
+#define AT91C_NFC_SR_NFCASE		(0x01 << 23)
+#define AT91C_NFC_SR_ERRORS		(AT91C_NFC_SR_DTOE | AT91C_NFC_SR_UNDEF\
+					| AT91C_NFC_SR_AWB | AT91C_NFC_SR_NFCASE)
+
+/*
+ * An NFC command is the address of its write in the NFC command space,
+ * the data written being the address cycles 1 to 4.
+ */
+#define AT91C_NFC_CMD1(x)		(((x) & 0xff) << 2)
+#define AT91C_NFC_CMD2(x)		(((x) & 0xff) << 10)
+#define AT91C_NFC_VCMD2			(0x01 << 18)
+#define AT91C_NFC_ACYCLE(x)		(((x) & 0x7) << 19)
+#define AT91C_NFC_CSID(x)		(((x) & 0x7) << 22)
+#define AT91C_NFC_DATAEN		(0x01 << 25)
+#define AT91C_NFC_NFCWR			(0x01 << 26)
+
 #endif	/* #ifndef __SAMA5_SMC_H__ */
@@ -86,7 +86,7 @@
  * User Peripherals physical base addresses.
  */
 #define AT91C_BASE_LCDC		0xf0000000
-#define AT91C_BASE_DMAC1	0xf0004000
+#define AT91C_BASE_XDMAC1	0xf0004000
 #define AT91C_BASE_ISI		0xf0008000
 
 #define AT91C_BASE_HSMCI0	0xf8000000
@@ -127,7 +127,7 @@
 /* Always Secure Mapping */
 #define AT91C_BASE_PKCC		0xf000c000
 #define AT91C_BASE_MPDDRC	0xf0010000
-#define AT91C_BASE_DMAC0	0xf0014000
+#define AT91C_BASE_XDMAC0	0xf0014000
 #define AT91C_BASE_PMC		0xf0018000
 #define AT91C_BASE_MATRIX64	0xf001c000
 #define AT91C_BASE_AESB		0xf0020000
@@ -188,7 +188,7 @@
 #define AT91C_BASE_CS1		0x60000000
 #define AT91C_BASE_CS2		0x70000000
 #define AT91C_BASE_CS3		0x80000000
-#define AT91C_BASE_NFC_CMDR	0x90000000
+#define AT91C_BASE_NFC_CMD	0x90000000
 
 /*
  * Other misc defines
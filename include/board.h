@@ -45,12 +45,20 @@ extern void hw_preinit(void);
 extern void hw_postinit(void);
 #endif
 
+/* Drops the load-time clock boost before control is handed over */
+#ifdef CONFIG_CPU_CLK_LOAD_BOOST
+extern void hw_postload(void);
+#else
+static inline void hw_postload(void) {}
+#endif
+
 extern void nandflash_hw_init(void);
 extern void nandflash_set_smc_timing(unsigned int mode);
 
 extern void at91_spi0_hw_init(void);
 
 extern void at91_qspi_hw_init(void);
+extern void at91_qspi_stripe_hw_init(void);
 
 extern void at91_mci0_hw_init(void);
 extern void at91_mci1_hw_init(void);
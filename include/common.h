@@ -34,7 +34,7 @@ struct image_info
 	unsigned int offset;
 	unsigned int length;
 #endif
-#ifdef CONFIG_SDCARD
+#ifdef CONFIG_MEDIA_SDCARD
 	char *filename;
 #ifdef CONFIG_OVERRIDE_CMDLINE_FROM_EXT_FILE
 	char *cmdline_file;
@@ -48,7 +48,7 @@ struct image_info
 	unsigned int of_offset;
 	unsigned int of_length;
 #endif
-#ifdef CONFIG_SDCARD
+#ifdef CONFIG_MEDIA_SDCARD
 	char *of_filename;
 #endif
 	unsigned char *of_dest;
@@ -74,6 +74,14 @@ extern int load_kernel(struct image_info *image);
 extern int kernel_size(unsigned char *addr);
 #endif
 
+#ifdef CONFIG_UIMAGE_CRC
+extern void uimage_crc_start(unsigned char *base);
+extern void uimage_crc_update(unsigned char *buf, unsigned int len);
+#else
+static inline void uimage_crc_start(unsigned char *base) {}
+static inline void uimage_crc_update(unsigned char *buf, unsigned int len) {}
+#endif
+
 extern void load_image_done(int retval);
 
 static inline unsigned int swap_uint32(unsigned int data)
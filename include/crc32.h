@@ -0,0 +1,19 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __CRC32_H__
+#define __CRC32_H__
+
+/*
+ * IEEE 802.3 CRC32 as used by uImage, zlib and U-Boot: crc32(0, buf, len)
+ * returns the checksum of buf, and a checksum can be carried on over
+ * consecutive buffers by passing the previous result as crc.
+ */
+extern unsigned int crc32(unsigned int crc,
+			  const unsigned char *buf,
+			  unsigned int len);
+
+#endif	/* #ifndef __CRC32_H__ */
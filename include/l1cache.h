@@ -53,4 +53,14 @@ void dcache_clean(void);
  */
 void dcache_invalidate(void);
 
+/**
+ * \brief Clean the data cache lines covering [start, end).
+ */
+void dcache_clean_region(unsigned int start, unsigned int end);
+
+/**
+ * \brief Invalidate the data cache lines covering [start, end).
+ */
+void dcache_invalidate_region(unsigned int start, unsigned int end);
+
 #endif /* L1CACHE_H_ */
@@ -17,6 +17,7 @@ extern void matrix_configure_slave_security(unsigned int matrix_base,
 extern int matrix_configure_peri_security(unsigned int *peri_id,
 					  unsigned int size);
 
+extern void matrix_cache_peri_security(void);
 extern int is_peripheral_secure(unsigned int periph_id);
 extern int is_sys_clk_secure(unsigned int sys_mask);
 extern int is_pck_clk_secure(unsigned int pck_mask);
@@ -30,6 +31,7 @@ extern void matrix_read_peripheral_security(unsigned int matrix_base);
 
 #ifdef CONFIG_SAMA7G5
 extern void matrix_configure_default_qos();
+extern void matrix_clear_master_qos(void);
 #endif
 
 #endif /* #ifndef __MATRIX_H__ */
@@ -153,6 +153,7 @@ struct sd_host {
 	unsigned int caps_max_clock;
 	unsigned int caps_min_clock;
 	unsigned int caps_voltages;
+	unsigned int caps_max_blocks;
 };
 
 struct sdcard_register {
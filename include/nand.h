@@ -9,7 +9,7 @@
 
 #define MAX_ECC_BYTES		512 /* maximum bytes of ecc */
 
-#if defined(CONFIG_SAMA5D2) || defined(CONFIG_SAMA5D3) ||\
+#if defined(CONFIG_SAMA5D2) || defined(CONFIG_SAMA5D3X) ||\
     defined(CONFIG_SAMA5D4) || defined(CONFIG_SAMA7G5)
 #define SMC_BASE	ATMEL_BASE_SMC
 #else
@@ -118,4 +118,13 @@ struct nand_info {
 
 extern void nandflash_smc_conf(unsigned int mode, unsigned int cs);
 
+extern int nand_check_badblock(struct nand_info *nand,
+			       unsigned int block,
+			       unsigned char *buffer);
+extern int nand_read_block_pages(struct nand_info *nand,
+				 unsigned int block,
+				 unsigned int start_page,
+				 unsigned int numpages,
+				 unsigned char *buffer);
+
 #endif /* #ifndef __NAND_H__ */
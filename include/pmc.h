@@ -58,6 +58,8 @@ struct pmc_pll_cfg {
 
 extern void pmc_init_pll(unsigned int pmc_pllicpr);
 extern int pmc_cfg_plla(unsigned int pmc_pllar);
+extern int pmc_sam9x60_start_pll(unsigned int pll_id, struct pmc_pll_cfg *cfg);
+extern void pmc_sam9x60_wait_pll(unsigned int mask, unsigned int *lock_ticks);
 extern void pmc_sam9x60_cfg_pll(unsigned int pll_id, struct pmc_pll_cfg *cfg);
 extern unsigned int pmc_get_pll_freq(unsigned int pll_id);
 
@@ -81,6 +83,7 @@ extern int pmc_enable_generic_clock(unsigned int periph_id,
 				    unsigned int clk_source,
 				    unsigned int div);
 extern unsigned int pmc_get_generic_clock(unsigned int periph_id);
+extern unsigned int pmc_get_generic_clock_source_rate(unsigned int clk_source);
 
 extern unsigned int pmc_read_reg(unsigned int reg_offset);
 extern int pmc_periph_clk(unsigned int periph_id, unsigned int is_on);
@@ -44,11 +44,25 @@ struct _PMECC_paramDesc_struct {
 
 };
 
+/* A page spans at most 8 sectors */
+#define PMECC_MAX_SECTORS	8
+
+/* PMECC state of a page, saved so that the next page can be read */
+struct pmecc_page {
+	unsigned int	erris;
+	unsigned int	correct_oob;
+	short		rem[PMECC_MAX_SECTORS][TT_MAX];
+};
+
 extern int get_pmecc_bytes(unsigned int sector_size, unsigned int ecc_bits);
 extern int choose_pmecc_info(struct nand_info *nand, struct nand_chip *chip);
 extern int init_pmecc(struct nand_info *nand);
 extern void pmecc_enable(void);
 extern void pmecc_start_data_phase(void);
 extern int pmecc_process(struct nand_info *nand, unsigned char *buffer);
+extern int pmecc_latch(struct nand_info *nand, unsigned char *buffer,
+		       struct pmecc_page *page);
+extern int pmecc_correct(struct nand_info *nand, unsigned char *buffer,
+			 struct pmecc_page *page);
 
 #endif
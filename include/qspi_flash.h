@@ -9,4 +9,9 @@
 
 int qspi_loadimage(struct image_info *image);
 
+#ifdef CONFIG_SPLIT_MEDIA
+int qspi_dt_load_start(struct image_info *image);
+int qspi_dt_load_wait(void);
+#endif
+
 #endif
@@ -11,6 +11,8 @@ extern void cpu_reset(void);
 
 extern void rstc_external_reset(void);
 
+extern unsigned int rstc_get_reset_type(void);
+
 extern void rstc_ddr_phy_rst_deassert(void);
 extern void rstc_ddr_rst_deassert(void);
 extern void rstc_ddr_assert(void);
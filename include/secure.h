@@ -19,6 +19,8 @@ typedef struct at91_secure_header {
 	unsigned int		reserved[2];
 } at91_secure_header_t;
 
+unsigned int secure_image_room(const struct image_info *image);
+int secure_image_length(const void *data, unsigned int max);
 int secure_check(void *data);
 
 #if defined(CONFIG_OCMS_STATIC)
@@ -19,4 +19,28 @@ struct smc_args_t {
 	unsigned int	r7;
 };
 
+/* SMC IDs handled by svc_mgr_main(), in r0 */
+#define SMC_PMC_PCK_SETUP	0x23
+#define SMC_PMC_READ_REG	0x24
+#define SMC_PMC_PERIPH_CLK	0x25
+#define SMC_PMC_SYS_CLK		0x26
+#define SMC_PMC_UCKR_CLK	0x27
+#define SMC_PMC_USB_SETUP	0x28
+#define SMC_CPU_RESET		0x29
+#define SMC_L2CACHE_ENABLE	0x42
+#define SMC_PMC_SMD_SETUP	0x50
+#define SMC_WDT_SET_COUNTER	0x60
+#define SMC_WDT_RELOAD_COUNTER	0x61
+#define SMC_STATS_READ		0x70
+#define SMC_STATS_RESET		0x71
+
+/*
+ * SMC_STATS_READ: r1 is the SMC ID, r2 selects the counter. The cycles
+ * only cover the calls counted as timed.
+ */
+#define SMC_STATS_COUNT		0
+#define SMC_STATS_CYCLES	1
+#define SMC_STATS_MAX_CYCLES	2
+#define SMC_STATS_TIMED		3
+
 #endif
@@ -12,6 +12,10 @@ extern int timer_init(void);
 extern void udelay(unsigned int usec);
 extern void mdelay(unsigned int msec);
 
+/* Free running tick counter, wraps at 32 bits */
+extern unsigned int timer_get_ticks(void);
+extern unsigned int timer_get_rate(void);
+
 extern int start_interval_timer(void);
 extern int wait_interval_timer(unsigned int usec);
 
@@ -0,0 +1,15 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __UBI_H__
+#define __UBI_H__
+
+struct nand_info;
+struct image_info;
+
+extern int ubi_load_image(struct nand_info *nand, struct image_info *image);
+
+#endif	/* #ifndef __UBI_H__ */
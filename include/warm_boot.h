@@ -0,0 +1,16 @@
+/*
+ * Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef __WARM_BOOT_H__
+#define __WARM_BOOT_H__
+
+struct image_info;
+
+extern int warm_boot_check(struct image_info *image);
+extern void warm_boot_prepare(struct image_info *image);
+extern void warm_boot_save(struct image_info *image);
+
+#endif	/* #ifndef __WARM_BOOT_H__ */
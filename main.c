@@ -16,6 +16,7 @@
 #include "autoconf.h"
 #include "optee.h"
 #include "sfr_aicredir.h"
+#include "ddr_bench.h"
 
 #ifdef CONFIG_CACHES
 #include "l1cache.h"
@@ -100,6 +101,10 @@ int main(void)
 	hw_postinit();
 #endif
 
+#ifdef CONFIG_DDR_BENCH
+	ddr_bench();
+#endif
+
 #ifdef CONFIG_LOAD_SW
 	init_load_image(&image);
 
@@ -134,6 +139,8 @@ int main(void)
 #endif
 	load_image_done(ret);
 
+	hw_postload();
+
 #ifdef CONFIG_SCLK
 #ifdef CONFIG_SCLK_BYPASS
 	slowclk_switch_osc32_bypass();
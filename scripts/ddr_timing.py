@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+#
+# SPDX-License-Identifier: MIT
+
+# Compile the datasheet parameters of a DRAM part into the MPDDRC register
+# image used by ddram_init() with CONFIG_DDR_SET_BY_TABLE.
+#
+# usage: ddr_timing.py [--mck MHZ] <.config> <part.json> <output.h>
+#
+# The part file gives the geometry, the CAS latency and the timings, either
+# in ns ("timings_ns") or in clock cycles ("timings_ck"). The memory clock
+# is the bus speed selected in .config unless --mck is given.
+
+import argparse
+import json
+import math
+import re
+import sys
+
+TYPES = {
+    # name: (MDR.MD, Kconfig symbol, supported CAS latencies)
+    "lpddr1": (0x3, "LPDDR1", (2, 3)),
+    "ddr2":   (0x6, "DDR2",   (3,)),
+    "lpddr2": (0x7, "LPDDR2", (3,)),
+    "ddr3":   (0x4, "DDR3",   (5, 6)),
+    "lpddr3": (0x5, "LPDDR3", (3, 6)),
+}
+
+DENSITIES = {
+    "DDR_64_MBIT": 64 << 20,
+    "DDR_128_MBIT": 128 << 20,
+    "DDR_256_MBIT": 256 << 20,
+    "DDR_512_MBIT": 512 << 20,
+    "DDR_1_GBIT": 1 << 30,
+    "DDR_2_GBIT": 2 << 30,
+    "DDR_4_GBIT": 4 << 30,
+    "DDR_8_GBIT": 8 << 30,
+}
+
+# Timing fields: (register, name, shift, width)
+FIELDS = {
+    "tras":   ("t0pr", "TRAS",   0, 4),
+    "trcd":   ("t0pr", "TRCD",   4, 4),
+    "twr":    ("t0pr", "TWR",    8, 4),
+    "trc":    ("t0pr", "TRC",   12, 4),
+    "trp":    ("t0pr", "TRP",   16, 4),
+    "trrd":   ("t0pr", "TRRD",  20, 4),
+    "twtr":   ("t0pr", "TWTR",  24, 4),
+    "tmrd":   ("t0pr", "TMRD",  28, 4),
+    "trfc":   ("t1pr", "TRFC",   0, 7),
+    "txsnr":  ("t1pr", "TXSNR",  8, 8),
+    "txsrd":  ("t1pr", "TXSRD", 16, 8),
+    "txp":    ("t1pr", "TXP",   24, 4),
+    "txard":  ("t2pr", "TXARD",  0, 4),
+    "txards": ("t2pr", "TXARDS", 4, 4),
+    "trpa":   ("t2pr", "TRPA",   8, 4),
+    "trtp":   ("t2pr", "TRTP",  12, 4),
+    "tfaw":   ("t2pr", "TFAW",  16, 4),
+}
+
+# Only DDR2 devices have the TXARD/TXARDS fields
+DDR2_ONLY = ("txard", "txards")
+
+REGISTERS = ("mdr", "cr", "rtr", "t0pr", "t1pr", "t2pr",
+             "lpr", "lpddr2_lpr", "tim_calr", "cal_mr4r")
+
+# Registers which may be given verbatim in the part file
+RAW_REGISTERS = ("lpr", "lpddr2_lpr", "tim_calr", "cal_mr4r")
+
+class TimingError(Exception):
+    pass
+
+def read_config(path):
+    config = {}
+    with open(path) as f:
+        for line in f:
+            m = re.match(r"(CONFIG_\w+)=(.*)", line.strip())
+            if m:
+                config[m.group(1)[7:]] = m.group(2).strip('"')
+    return config
+
+def config_mck(config):
+    for key in config:
+        m = re.match(r"BUS_SPEED_(\d+)MHZ$", key)
+        if m and config[key] == "y":
+            return int(m.group(1))
+    raise TimingError("no CONFIG_BUS_SPEED_*MHZ in .config, use --mck")
+
+def ns_to_ck(ns, mck):
+    # round up, ignoring the float noise of values like 12.5 ns * 200 MHz
+    return int(math.ceil(ns * mck / 1000.0 - 1e-6))
+
+def cycles(part, name, mck):
+    ns = part.get("timings_ns", {})
+    ck = part.get("timings_ck", {})
+    if name in ns and name in ck:
+        raise TimingError("%s is given both in ns and in clock cycles" % name)
+    if name in ck:
+        return int(ck[name])
+    if name in ns:
+        return ns_to_ck(float(ns[name]), mck)
+    return None
+
+def field(value, name, shift, width):
+    if value < 0 or value >= (1 << width):
+        raise TimingError("%s = %d does not fit in %d bits"
+                          % (name, value, width))
+    return value << shift
+
+def compile_part(config, part, mck):
+    regs = dict.fromkeys(REGISTERS, 0)
+
+    kind = part["type"].lower()
+    if kind not in TYPES:
+        raise TimingError("unknown DRAM type '%s'" % part["type"])
+    md, symbol, cas_list = TYPES[kind]
+    if config.get(symbol) != "y":
+        raise TimingError("part is %s but .config does not select CONFIG_%s"
+                          % (kind, symbol))
+
+    dbw = int(part["bus_width"])
+    if dbw not in (16, 32):
+        raise TimingError("bus width must be 16 or 32, not %d" % dbw)
+    if config.get("DBW_32") == "y" and dbw != 32 or \
+       config.get("DBW_16") == "y" and dbw != 16:
+        raise TimingError("bus width %d does not match .config" % dbw)
+
+    rows = int(part["rows"])
+    cols = int(part["columns"])
+    banks = int(part["banks"])
+    cas = int(part["cas"])
+    if not 11 <= rows <= 14:
+        raise TimingError("%d row bits, the controller supports 11 to 14"
+                          % rows)
+    if not 9 <= cols <= 12:
+        raise TimingError("%d column bits, the controller supports 9 to 12"
+                          % cols)
+    if banks not in (4, 8):
+        raise TimingError("%d banks, the controller supports 4 or 8" % banks)
+    if cas not in cas_list:
+        raise TimingError("CAS latency %d is not supported for %s"
+                          % (cas, kind))
+
+    size = (1 << (rows + cols)) * banks * dbw
+    for key, bits in DENSITIES.items():
+        if config.get(key) == "y" and bits != size:
+            raise TimingError("part geometry gives %d Mbit, .config has %s"
+                              % (size >> 20, key))
+
+    regs["mdr"] = md | (0x1 << 4 if dbw == 16 else 0)
+
+    regs["cr"] = (cols - 9) | ((rows - 11) << 2) | (cas << 4)
+    regs["cr"] |= (0x1 << 20) if banks == 8 else 0
+    if config.get("NOT_DQS_DISABLED") == "y":
+        regs["cr"] |= 0x1 << 21
+    if kind == "lpddr2":
+        regs["cr"] |= 0x2 << 10		# ZQ short calibration
+    if kind == "ddr3":
+        regs["cr"] |= 0x1 << 9		# DLL disabled
+        regs["cr"] |= (6 if mck > 200 else 5) << 26	# CAS write latency
+        regs["cr"] |= 0x1 << 8		# RZQ/7 output drive
+    regs["cr"] |= 0x1 << 22			# interleaved decoding
+    regs["cr"] |= 0x1 << 23			# unaligned access
+
+    ck = {}
+    for name, (reg, fname, shift, width) in FIELDS.items():
+        value = cycles(part, name, mck)
+        if value is None:
+            if name in DDR2_ONLY and kind != "ddr2":
+                value = 0
+            else:
+                raise TimingError("missing timing %s" % name)
+        elif name in DDR2_ONLY and kind != "ddr2":
+            raise TimingError("%s only applies to DDR2 devices" % name)
+        ck[name] = value
+        regs[reg] |= field(value, "%s.%s" % (reg.upper(), fname),
+                           shift, width)
+
+    if ck["twtr"] < 1:
+        raise TimingError("tWTR must be at least one clock cycle")
+    if ck["trc"] < ck["tras"] + ck["trp"]:
+        raise TimingError("tRC (%d) is shorter than tRAS + tRP (%d)"
+                          % (ck["trc"], ck["tras"] + ck["trp"]))
+    if ck["txsnr"] < ck["trfc"]:
+        raise TimingError("tXSNR (%d) is shorter than tRFC (%d)"
+                          % (ck["txsnr"], ck["trfc"]))
+
+    # Refresh Timer is (refresh_window / refresh_cycles) * master_clock,
+    # rounded down so that the rows are never refreshed late
+    trefi = float(part["trefi_ns"])
+    regs["rtr"] = field(int(trefi * mck / 1000.0), "RTR.COUNT", 0, 12)
+
+    for name, value in part.get("registers", {}).items():
+        if name not in RAW_REGISTERS:
+            raise TimingError("register %s cannot be set directly" % name)
+        regs[name] = int(str(value), 0) & 0xffffffff
+
+    return regs, ck
+
+def write_header(path, source, part, mck, regs, ck):
+    with open(path, "w") as f:
+        f.write("/* Generated by scripts/ddr_timing.py from %s, do not edit */\n"
+                % source)
+        f.write("\n#ifndef __DDRAM_TABLE_H__\n#define __DDRAM_TABLE_H__\n\n")
+        f.write("/*\n * %s, %s at %d MHz\n *\n"
+                % (part.get("name", source), part["type"].upper(), mck))
+        for name in FIELDS:
+            f.write(" * %-7s %3d tCK\n" % (name, ck[name]))
+        f.write(" */\n")
+        f.write("static const struct ddramc_register ddramc_table = {\n")
+        for name in REGISTERS:
+            f.write("\t.%-11s= 0x%08x,\n" % (name, regs[name]))
+        f.write("};\n\n#endif /* #ifndef __DDRAM_TABLE_H__ */\n")
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compile DRAM parameters into MPDDRC register values")
+    parser.add_argument("--mck", type=int,
+                        help="memory clock in MHz, default from .config")
+    parser.add_argument("config", help=".config of the build")
+    parser.add_argument("part", help="DRAM parameter file (JSON)")
+    parser.add_argument("output", help="generated header")
+    args = parser.parse_args()
+
+    config = read_config(args.config)
+    with open(args.part) as f:
+        part = json.load(f)
+
+    try:
+        mck = args.mck or config_mck(config)
+        regs, ck = compile_part(config, part, mck)
+    except TimingError as e:
+        sys.stderr.write("%s: %s\n" % (args.part, e))
+        sys.exit(1)
+    except KeyError as e:
+        sys.stderr.write("%s: missing parameter %s\n" % (args.part, e))
+        sys.exit(1)
+
+    write_header(args.output, args.part, part, mck, regs, ck)
+
+if __name__ == "__main__":
+    main()
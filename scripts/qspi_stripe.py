@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2026 Microchip Technology Inc. and its subsidiaries
+#
+# SPDX-License-Identifier: MIT
+
+# Split an image for CONFIG_QSPI_STRIPE, or merge the two halves back.
+#
+# usage: qspi_stripe.py split [--stripe-size SIZE] <image> <boot.bin> <other.bin>
+#        qspi_stripe.py merge [--stripe-size SIZE] <boot.bin> <other.bin> <image>
+#
+# The image is the part of the payload stored from CONFIG_QSPI_STRIPE_OFFSET
+# on. Stripe 0 goes to the boot flash, stripe 1 to the flash on the other
+# QSPI bus, and so on. Both outputs are written at CONFIG_QSPI_STRIPE_OFFSET
+# in their flash.
+
+import argparse
+import sys
+
+def split(data, size):
+    halves = [bytearray(), bytearray()]
+    for n, start in enumerate(range(0, len(data), size)):
+        halves[n & 1] += data[start:start + size]
+    return halves
+
+def merge(boot, other, size):
+    data = bytearray()
+    halves = [boot, other]
+    offsets = [0, 0]
+    n = 0
+    while offsets[n & 1] < len(halves[n & 1]):
+        chip = n & 1
+        data += halves[chip][offsets[chip]:offsets[chip] + size]
+        offsets[chip] += size
+        n += 1
+    return data
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Split or merge an image striped over two QSPI flashes")
+    parser.add_argument("--stripe-size", type=lambda x: int(x, 0),
+                        default=0x10000,
+                        help="CONFIG_QSPI_STRIPE_SIZE, default 0x10000")
+    sub = parser.add_subparsers(dest="cmd")
+    sub.required = True
+    p = sub.add_parser("split", help="split an image in two halves")
+    p.add_argument("image")
+    p.add_argument("boot")
+    p.add_argument("other")
+    p = sub.add_parser("merge", help="rebuild an image from its halves")
+    p.add_argument("boot")
+    p.add_argument("other")
+    p.add_argument("image")
+    args = parser.parse_args()
+
+    if args.stripe_size <= 0:
+        sys.stderr.write("stripe size must be positive\n")
+        sys.exit(1)
+
+    if args.cmd == "split":
+        with open(args.image, "rb") as f:
+            data = f.read()
+        boot, other = split(data, args.stripe_size)
+        with open(args.boot, "wb") as f:
+            f.write(boot)
+        with open(args.other, "wb") as f:
+            f.write(other)
+    else:
+        with open(args.boot, "rb") as f:
+            boot = f.read()
+        with open(args.other, "rb") as f:
+            other = f.read()
+        with open(args.image, "wb") as f:
+            f.write(merge(boot, other, args.stripe_size))
+
+if __name__ == "__main__":
+    main()